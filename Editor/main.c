@@ -3,6 +3,7 @@
 //#include <SDL2/SDL_ttf.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "maze.h"
 
 // Global variables
@@ -12,8 +13,9 @@ const int INIT_HEIGHT = 480;        // Initial screen height (pixels)
 int SCREEN_WIDTH = INIT_WIDTH;      // Screen width (pixels)
 int SCREEN_HEIGHT = INIT_HEIGHT;    // Screen height (pixels)
 int MAZE_PADDING = 50;              // Padding between maze border and edge of screen (pixels)
-int WALL_THICKNESS = 10;            // Thickness of maze wall (pixels)
-int MAX_MAZE_SIZE = 16;             // Maximum maze dimensions (cells)
+int MAX_WALL_THICKNESS = 10;        // Thickness of maze wall when cells are large enough (pixels)
+int WALL_THICKNESS = 10;            // Thickness of maze wall, shrunk for large mazes (pixels)
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
 int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
 int MAZE_WIDTH;                     // Width of maze border wall (pixels)
 int CELL_LENGTH;                    // Length of one cell (pixels)
@@ -22,7 +24,10 @@ int MIN_SCREEN_DIMENSION;           // Store the smaller screen dimension out of
 int MAX_SCREEN_DIMENSION;           // Store the larger screen dimension out of the width and height (pixels)
 char mazePath[64];                  // Name of default maze file used if no maze path provided
 char *mazeDirectory = "../Mazes/";  // Path to maze folder
-int SELECTION_PADDING = 10;         // Border around walls to check for clicks
+int MAX_SELECTION_PADDING = 10;     // Border around walls to check for clicks when cells are large enough (pixels)
+int SELECTION_PADDING = 10;         // Border around walls to check for clicks (pixels)
+int painting = -1;                  // Wall state being painted while the mouse button is held, -1 if not painting
+int lastX, lastY;                   // Last mouse position of the current paint stroke (pixels)
 
 // Global structs/objects
 SDL_Window* window = NULL;
@@ -34,6 +39,7 @@ Maze maze;
 int init();
 int resizeWindow(int width, int height);
 int quit();
+void updateCellLength();
 void renderScreen();
 //void renderText();
 
@@ -58,7 +64,8 @@ int main(int argc, char** argv)
     // Initialize application
     if(!init()) return -1;
 
-    CELL_LENGTH = MAZE_WIDTH / maze.size;
+    updateCellLength();
+    maze.mazeTexture = createMazeTexture(&maze);
 
     // Render initial maze to screen
     renderScreen();
@@ -66,13 +73,15 @@ int main(int argc, char** argv)
     // Program loop
     while(1)
     {
-        // Process event queue
+        // Sleep until something happens, then process the whole event queue and render once for all of it, so a
+        // drag that crosses many walls costs a single screen update
+        int changed = 0;
+        SDL_WaitEvent(NULL);
         while(SDL_PollEvent(&e) != 0)
         {
             // Quit if close button is pressed
             if(e.type == SDL_QUIT) return quit();
 
-            // Re-render window and maze if window is resized
             else if(e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
             {
                 // Calculate new maze size constants
@@ -81,7 +90,7 @@ int main(int argc, char** argv)
                 MIN_SCREEN_DIMENSION = (SCREEN_WIDTH <= SCREEN_HEIGHT) ? SCREEN_WIDTH : SCREEN_HEIGHT;
                 MAX_SCREEN_DIMENSION = (SCREEN_WIDTH <= SCREEN_HEIGHT) ? SCREEN_HEIGHT : SCREEN_WIDTH;
                 MAZE_WIDTH = MIN_SCREEN_DIMENSION - 2*MAZE_PADDING;
-                CELL_LENGTH = MAZE_WIDTH / maze.size;
+                updateCellLength();
 
                 // Calculate new maze origin
                 if(SCREEN_WIDTH >= SCREEN_HEIGHT)
@@ -95,20 +104,29 @@ int main(int argc, char** argv)
                     y_0 = (MAX_SCREEN_DIMENSION - MAZE_WIDTH)/2; 
                 }
 
-                // Display resized maze
+                // Redraw the cached maze for the new layout and display it
+                maze.mazeTexture = createMazeTexture(&maze);
                 renderScreen();
             }
             
+            // Toggle the clicked wall and paint that state along the drag until the button is released
             else if(e.type == SDL_MOUSEBUTTONDOWN)
             {
-                int mx, my;
-                SDL_GetMouseState(&mx, &my);
-                updateWall(&maze, mx, my);
+                painting = updateWall(&maze, e.button.x, e.button.y);
+                lastX = e.button.x;
+                lastY = e.button.y;
+                changed |= painting >= 0;
+            }
 
-                // Display updated maze
-                renderScreen();
+            else if(e.type == SDL_MOUSEMOTION && painting >= 0)
+            {
+                changed |= paintWalls(&maze, lastX, lastY, e.motion.x, e.motion.y, painting) > 0;
+                lastX = e.motion.x;
+                lastY = e.motion.y;
             }
 
+            else if(e.type == SDL_MOUSEBUTTONUP) painting = -1;
+
             else if(e.type == SDL_KEYDOWN)
             {
                 switch(e.key.keysym.sym)
@@ -121,11 +139,28 @@ int main(int argc, char** argv)
                 }
             }
         }
+
+        // Display updated maze
+        if(changed) renderScreen();
     }
 
     return 0;
 }
 
+// Fit cells to the maze area, thinning walls and click borders so large mazes stay editable
+void updateCellLength()
+{
+    CELL_LENGTH = MAZE_WIDTH / maze.size;
+    if(CELL_LENGTH < 2) CELL_LENGTH = 2;
+
+    WALL_THICKNESS = CELL_LENGTH / 4;
+    if(WALL_THICKNESS > MAX_WALL_THICKNESS) WALL_THICKNESS = MAX_WALL_THICKNESS;
+    if(WALL_THICKNESS < 1) WALL_THICKNESS = 1;
+
+    SELECTION_PADDING = CELL_LENGTH / 4;
+    if(SELECTION_PADDING > MAX_SELECTION_PADDING) SELECTION_PADDING = MAX_SELECTION_PADDING;
+}
+
 // Renders maze to screen
 void renderScreen()
 {
@@ -1,7 +1,11 @@
 #include "maze.h"
+#include <fcntl.h>
+#include <stdarg.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 // Access global variables from main.c
@@ -10,145 +14,272 @@ extern SDL_Renderer* renderer;
 extern int SELECTION_PADDING;
 extern char *mazeDirectory;
 
-// Load maze from specified path if path is provided
-int loadMaze(Maze *maze, const char *path)
+// Allocate zeroed wall arrays for a maze of the given size
+// Returns 1 on success, 0 if memory could not be allocated
+int allocateMaze(Maze *maze, int size)
 {
-    // If maze pointer passed in was NULL, exit
-    if(maze == NULL) return 0;
+    free(maze->hWalls);
+    free(maze->vWalls);
+    maze->size = size;
+    maze->hWalls = calloc((size_t) (size - 1) * size, 1);
+    maze->vWalls = calloc((size_t) size * (size - 1), 1);
 
-    // File loading variables
-    FILE *file;
-    char *buffer = (char *) malloc(64);
-    char *filePath[100] = {0};
-    int lineLength = 0;
-    int mazeSize = 0;
+    if(!maze->hWalls || !maze->vWalls)
+    {
+        printf("Error: Unable to allocate memory for %dx%d maze\n", size, size);
+        return 0;
+    }
 
-    // Load specified maze file or default one if NULL path provided
-    strcat(filePath, mazeDirectory);
-    if(path) strcat(filePath, path);
-    else strcat(filePath, "default.txt");
+    return 1;
+}
 
-    // Open maze file
-    file = fopen(filePath, "r");
+// Cursor over the lines of a memory-mapped maze file
+typedef struct
+{
+    const char *next;       // Start of the next line
+    const char *end;        // End of the file
+    const char *filePath;
+    int number;             // Number of the line last read, starting at 1
+} LineReader;
+
+// Reads the next line without its line ending (\n or \r\n)
+// Returns 1 if there was another line, 0 at the end of the file
+static int readLine(LineReader *reader, const char **line, int *length)
+{
+    if(reader->next >= reader->end) return 0;
+
+    const char *start = reader->next;
+    const char *newline = memchr(start, '\n', reader->end - start);
+    const char *stop = newline ? newline : reader->end;
+    reader->next = newline ? newline + 1 : reader->end;
+    if(stop > start && stop[-1] == '\r') stop--;
+
+    *line = start;
+    *length = stop - start;
+    reader->number++;
+    return 1;
+}
+
+// Prints a parse error at the given column (starting at 1) of the line last read
+// Always returns 0 so callers can return its result
+static int parseError(LineReader *reader, int column, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    printf("Error: %s line %d, column %d: ", reader->filePath, reader->number, column);
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+    return 0;
+}
+
+// Returns 1 if the wall post at column c of wall line r (counting from the top border line) touches a wall
+// line is wall line r; above and below are the neighboring wall lines, NULL past the borders
+static int postTouchesWall(const char *line, int length, const char *above, int aboveLength, const char *below,
+                           int belowLength, int c)
+{
+    if(c > 0 && line[c - 1] == 'x') return 1;
+    if(c + 1 < length && line[c + 1] == 'x') return 1;
+    if(above && c < aboveLength && above[c] == 'x') return 1;
+    if(below && c < belowLength && below[c] == 'x') return 1;
+    return 0;
+}
 
-    // Check if file exists
-    if(access(filePath, F_OK) == 0)
+// Parses maze text straight into the maze's wall storage in a single pass, rejecting anything that does not
+// follow the maze file format (see Mazes/README.md)
+// Returns 1 on success, 0 after printing the line and column of the first problem found
+static int parseMaze(Maze *maze, LineReader *reader)
+{
+    const char *line;
+    int length;
+
+    // Maze name (1st line)
+    if(!readLine(reader, &line, &length)) return parseError(reader, 1, "missing maze name");
+    if(length >= (int) sizeof(maze->name))
     {
+        return parseError(reader, sizeof(maze->name), "maze name is longer than %d characters", (int) sizeof(maze->name) - 1);
+    }
+    memcpy(maze->name, line, length);
+    maze->name[length] = '\0';
+
+    // Maze size (2nd line)
+    if(!readLine(reader, &line, &length)) return parseError(reader, 1, "missing maze size");
+    int mazeSize = 0;
+    for(int c = 0; c < length; c++)
+    {
+        if(line[c] < '0' || line[c] > '9') return parseError(reader, c + 1, "maze size must be a whole number");
+        if(mazeSize <= MAX_MAZE_SIZE) mazeSize = mazeSize * 10 + line[c] - '0';
+    }
+    if(length == 0) return parseError(reader, 1, "missing maze size");
+    if(mazeSize < MIN_MAZE_SIZE || mazeSize > MAX_MAZE_SIZE)
+    {
+        return parseError(reader, 1, "maze size must be between %d and %d", MIN_MAZE_SIZE, MAX_MAZE_SIZE);
+    }
+
+    printf("Maze name: %s\n", maze->name);
+    printf("Maze size: %d\n", mazeSize);
+
+    maze->mazeTexture = NULL;
+    if(!allocateMaze(maze, mazeSize)) return 0;
+
+    // Wall lines: 2n + 1 lines alternating between horizontal walls (even lines, starting with the top border)
+    // and vertical walls (odd lines). Columns alternate between wall posts (even) and cells or walls (odd), except
+    // that horizontal lines written by saveMaze draw each wall as two characters ("xx") and are 2n + 3 characters long
+    // Wall line r describes row r / 2 of the wall arrays (for horizontal lines, the row above the line)
+    int width = 2 * mazeSize + 1;
+    const char *above = NULL;
+    int aboveLength = 0;
+    for(int r = 0; r < width; r++)
+    {
+        if(!readLine(reader, &line, &length))
+        {
+            return parseError(reader, 1, "file ends after %d of %d wall lines", r, width);
+        }
+
+        for(int c = 0; c < length; c++)
+        {
+            if(line[c] != 'x' && line[c] != ' ') return parseError(reader, c + 1, "unexpected character '%c'", line[c]);
+        }
+
+        int row = r / 2 - (r % 2 == 0);
+        int border = (r == 0 || r == width - 1);
+        int pairs = (r % 2 == 0 && !border && length == width + 2);
+        if(length != width && !pairs)
+        {
+            // Point at the first missing or extra character
+            int longest = (r % 2 == 0 && !border) ? width + 2 : width;
+            int column = (length < width ? length : length > longest ? longest : width) + 1;
+            if(longest > width)
+            {
+                return parseError(reader, column, "expected %d or %d characters, found %d", width, longest, length);
+            }
+            return parseError(reader, column, "expected %d characters, found %d", width, length);
+        }
 
-        if(!file)
+        if(line[0] != 'x') return parseError(reader, 1, "gap in border wall");
+        if(line[length - 1] != 'x') return parseError(reader, length, "gap in border wall");
+
+        if(border)
+        {
+            const char *gap = memchr(line, ' ', length);
+            if(gap) return parseError(reader, gap - line + 1, "gap in border wall");
+        }
+        else if(r % 2 == 1)
+        {
+            // Vertical walls: even columns are walls east of cell c / 2 - 1, odd columns are cell interiors
+            for(int c = 1; c < width - 1; c++)
+            {
+                if(c % 2 == 1 && line[c] != ' ') return parseError(reader, c + 1, "wall inside cell");
+                if(c % 2 == 0 && line[c] == 'x') V_WALL(maze, row, c / 2 - 1) = 1;
+            }
+        }
+        else if(pairs)
+        {
+            // Horizontal walls as saved by saveMaze: columns 2k + 1 and 2k + 2 both describe the wall below cell k
+            for(int k = 0; k < mazeSize; k++)
+            {
+                if(line[2 * k + 1] != line[2 * k + 2]) return parseError(reader, 2 * k + 2, "wall halves do not match");
+                if(line[2 * k + 1] == 'x') H_WALL(maze, row, k) = 1;
+            }
+        }
+        else
+        {
+            // Horizontal walls: odd columns are walls below cell c / 2, even columns are wall posts, which
+            // must touch a wall if drawn
+            LineReader peek = *reader;
+            const char *below = NULL;
+            int belowLength = 0;
+            readLine(&peek, &below, &belowLength);
+            for(int c = 1; c < width - 1; c++)
+            {
+                if(c % 2 == 1 && line[c] == 'x') H_WALL(maze, row, c / 2) = 1;
+                if(c % 2 == 0 && line[c] == 'x' && !postTouchesWall(line, length, above, aboveLength, below, belowLength, c))
+                {
+                    return parseError(reader, c + 1, "wall post does not touch any wall");
+                }
+            }
+        }
+
+        above = line;
+        aboveLength = length;
+    }
+
+    // Only blank lines may follow the maze
+    while(readLine(reader, &line, &length))
+    {
+        for(int c = 0; c < length; c++)
         {
-            printf("Error: Could not open file %s\n", filePath);
-            return 0;
+            if(line[c] != ' ' && line[c] != '\t') return parseError(reader, c + 1, "unexpected text after maze");
         }
     }
 
+    return 1;
+}
+
+// Load maze from specified path if path is provided, or create a new blank maze if the file does not exist
+// The file is memory-mapped and parsed in place; returns 1 on success, 0 if it could not be read or is malformed
+int loadMaze(Maze *maze, const char *path)
+{
+    // If maze pointer passed in was NULL, exit
+    if(maze == NULL) return 0;
+
+    // Load specified maze file or default one if NULL path provided
+    char filePath[512];
+    snprintf(filePath, sizeof(filePath), "%s%s", mazeDirectory, path ? path : "default.txt");
+
     // File does not exist, create new blank maze file
-    else
+    if(access(filePath, F_OK) != 0)
     {
+        int mazeSize = 0;
         printf("Maze file does not exist, creating new maze file\n");
         printf("Enter a name for the maze: ");
-        scanf("%[^\n]%*c", buffer);
-        strcpy(maze->name, buffer);
+        scanf("%63[^\n]%*c", maze->name);
 
         do
         {
             printf("Enter a maze size: ");
             scanf("%d", &mazeSize);
 
-            if(mazeSize < 2 || mazeSize > 16) printf("Error: maze size must be between 2 and 16\n");
+            if(mazeSize < MIN_MAZE_SIZE || mazeSize > MAX_MAZE_SIZE) printf("Error: maze size must be between %d and %d\n", MIN_MAZE_SIZE, MAX_MAZE_SIZE);
 
-        } while (mazeSize < 2 || mazeSize > 16);
+        } while (mazeSize < MIN_MAZE_SIZE || mazeSize > MAX_MAZE_SIZE);
 
-        maze->size = mazeSize;
         maze->mazeTexture = NULL;
 
-        // Set maze wall arrays to all zeros
-        int h_walls[17][16] = {0};
-        int v_walls[16][17] = {0};
-        memcpy(maze->hWalls, h_walls, sizeof(int) * 17 * 16);
-        memcpy(maze->vWalls, v_walls, sizeof(int) * 17 * 16);
-
-        return 1;
+        // Start with all inner walls cleared
+        return allocateMaze(maze, mazeSize);
     }
-    
-    printf("Successfully opened file %s\n", filePath);
-
-    // Read maze name from file (1st line) and copy to maze's name array
-    fscanf(file, "%[^\n]", buffer);
-    strncpy(maze->name, buffer, 64);
 
-    // Read maze size from file (2nd line) and copy to maze's size variable
-    fscanf(file, "%d", &(maze->size));
-    mazeSize = maze->size;
-
-    // Ensure maze size is valid
-    if(mazeSize < MIN_MAZE_SIZE || mazeSize > MAX_MAZE_SIZE)
+    // Map maze file into memory
+    int file = open(filePath, O_RDONLY);
+    struct stat info;
+    if(file < 0 || fstat(file, &info))
     {
-        printf("Error: Invalid maze size\n");
-        fclose(file);
+        printf("Error: Could not open file %s\n", filePath);
+        if(file >= 0) close(file);
         return 0;
     }
-
-    // Print maze name and size to terminal
-    printf("Maze name: %s\n", maze->name);
-    printf("Maze size: %d\n", maze->size);
-    
-    // Maze loading variables
-    maze->mazeTexture = NULL;
-    int h_walls[17][16] = {0};
-    int v_walls[16][17] = {0};
-    char *hBuff = (char *) malloc(34);
-    char *vBuff = (char *) malloc(34);
-    int hCounter;
-    int vCounter;
-
-    // Get rid of first line (top border wall)
-    getline(&buffer, &lineLength, file);
-    getline(&buffer, &lineLength, file);
-
-    // Process two lines at a time up to second-to-last line and detect horizontal and vertical walls
-    for(int i = 0; i < mazeSize - 1; i++)
+    if(info.st_size == 0)
     {
-        getline(&vBuff, &lineLength, file);
-        getline(&hBuff, &lineLength, file);
-        
-        vCounter = 0;
-        for(int j = 2; j <= 2*mazeSize - 1; j += 2)
-        {
-            if(vBuff[j] == 'x') v_walls[i][vCounter] = 1;
-            vCounter++;
-        }
-
-        hCounter = 0;
-        for(int k = 1; k <= 2*mazeSize + 1; k += 2)
-        {
-            if(hBuff[k] == 'x') h_walls[i][hCounter] = 1;
-            hCounter++;
-        }
+        printf("Error: %s is empty\n", filePath);
+        close(file);
+        return 0;
     }
-
-    // Process last line (bottom maze row with vertical walls)
-    getline(&vBuff, &lineLength, file);
-    vCounter = 0;
-    for(int i = 2; i <= 2*mazeSize - 1; i += 2)
+    char *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(data == MAP_FAILED)
     {
-        if(vBuff[i] == 'x') v_walls[mazeSize - 1][vCounter] = 1;
-        vCounter++;
+        printf("Error: Could not read file %s\n", filePath);
+        return 0;
     }
 
-    // Free temporary buffers
-    free(buffer);
-    free(hBuff);
-    free(vBuff);
-
-    // Store wall data into maze's wall arrays
-    memcpy(maze->hWalls, h_walls, sizeof(int) * 17 * 16);
-    memcpy(maze->vWalls, v_walls, sizeof(int) * 17 * 16);
+    printf("Successfully opened file %s\n", filePath);
 
-    // Close file
-    fclose(file);
+    LineReader reader = {data, data + info.st_size, filePath, 0};
+    int result = parseMaze(maze, &reader);
+    munmap(data, info.st_size);
 
-    return 1;
+    return result;
 }
 
 int saveMaze(Maze *maze, const char *path)
@@ -158,7 +289,7 @@ int saveMaze(Maze *maze, const char *path)
 
     // File loading variables
     FILE *file;
-    char *filePath[100] = {0};
+    char filePath[512] = {0};
     int mazeSize = maze->size;
     int hCounter;
     int vCounter;
@@ -193,7 +324,7 @@ int saveMaze(Maze *maze, const char *path)
         for(int j = 2; j <= 2*mazeSize - 1; j += 2)
         {
             fprintf(file, " ");
-            if(maze->vWalls[i][vCounter] == 1) fprintf(file, "x");
+            if(V_WALL(maze, i, vCounter)) fprintf(file, "x");
             else fprintf(file, " ");
             vCounter++;
         }
@@ -201,21 +332,14 @@ int saveMaze(Maze *maze, const char *path)
 
         hCounter = 0;
         fprintf(file, "x");
-        for(int k = 1; k <= 2*mazeSize + 1; k += 2)
+        for(int k = 1; k <= 2*mazeSize - 1; k += 2)
         {
-            if(k == 2*mazeSize + 1)
-            {
-                if(maze->hWalls[i][hCounter] == 1) fprintf(file, "xx\n");
-                else fprintf(file, " x\n");
-            }
-            else
-            {
-                if(maze->hWalls[i][hCounter] == 1) fprintf(file, "xx");
-                else fprintf(file, "  ");
-            }
+            if(H_WALL(maze, i, hCounter)) fprintf(file, "xx");
+            else fprintf(file, "  ");
             
             hCounter++;
         }
+        fprintf(file, " x\n");
     }
 
     // Process last line (bottom maze row with vertical walls)
@@ -224,7 +348,7 @@ int saveMaze(Maze *maze, const char *path)
     for(int i = 2; i <= 2*mazeSize - 1; i += 2)
     {
         fprintf(file, " ");
-        if(maze->vWalls[mazeSize - 1][vCounter] == 1) fprintf(file, "x");
+        if(V_WALL(maze, mazeSize - 1, vCounter)) fprintf(file, "x");
         else fprintf(file, " ");
         vCounter++;
     }
@@ -243,126 +367,225 @@ int saveMaze(Maze *maze, const char *path)
     return 1;
 }
 
-// Render maze to screen
-int renderMaze(Maze *maze)
+// Walls are drawn in batches: filled rectangles for walls and outlines for empty wall slots, one draw call each
+#define WALL_BATCH 1024
+
+typedef struct
 {
-    // Draw white background
-    SDL_Rect tempRect = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
-    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);    
-    SDL_RenderFillRect(renderer, &tempRect);
+    SDL_Rect filled[WALL_BATCH];
+    SDL_Rect outlines[WALL_BATCH];
+    int filledCount;
+    int outlineCount;
+} WallBatch;
 
-    // Create border walls
+static void flushWalls(WallBatch *batch)
+{
+    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
+    if(batch->filledCount) SDL_RenderFillRects(renderer, batch->filled, batch->filledCount);
+    if(batch->outlineCount) SDL_RenderDrawRects(renderer, batch->outlines, batch->outlineCount);
+    batch->filledCount = batch->outlineCount = 0;
+}
+
+static void addWall(WallBatch *batch, SDL_Rect rect, int present)
+{
+    if(present) batch->filled[batch->filledCount++] = rect;
+    else batch->outlines[batch->outlineCount++] = rect;
+    if(batch->filledCount == WALL_BATCH || batch->outlineCount == WALL_BATCH) flushWalls(batch);
+}
+
+// Draws the maze border and the wall slots around the cells in rows top to bottom and columns left to right
+static void drawWalls(Maze *maze, int top, int bottom, int left, int right)
+{
+    static WallBatch batch;
+    if(top < 0) top = 0;
+    if(left < 0) left = 0;
+    if(bottom > maze->size - 1) bottom = maze->size - 1;
+    if(right > maze->size - 1) right = maze->size - 1;
+
+    // Vertical walls right of each cell except the last column
+    for(int i = top; i <= bottom; i++)
+    {
+        for(int j = left; j <= right && j < maze->size - 1; j++)
+        {
+            SDL_Rect rect = {x_0 + CELL_LENGTH * (j + 1), y_0 + CELL_LENGTH * i, WALL_THICKNESS, CELL_LENGTH + WALL_THICKNESS};
+            addWall(&batch, rect, V_WALL(maze, i, j));
+        }
+    }
+
+    // Horizontal walls below each cell except the bottom row
+    for(int i = top; i <= bottom && i < maze->size - 1; i++)
+    {
+        for(int j = left; j <= right; j++)
+        {
+            SDL_Rect rect = {x_0 + CELL_LENGTH * j, y_0 + CELL_LENGTH * (i + 1), CELL_LENGTH + WALL_THICKNESS, WALL_THICKNESS};
+            addWall(&batch, rect, H_WALL(maze, i, j));
+        }
+    }
+
+    // Maze border
     SDL_Rect mazeBorders[4] = {
         {x_0, y_0, (CELL_LENGTH * maze->size) + WALL_THICKNESS, WALL_THICKNESS},
         {x_0, y_0, WALL_THICKNESS, (CELL_LENGTH * maze->size) + WALL_THICKNESS},
         {x_0 + (CELL_LENGTH * maze->size), y_0, WALL_THICKNESS, (CELL_LENGTH * maze->size) + WALL_THICKNESS},
         {x_0, y_0 + (CELL_LENGTH * maze->size), (CELL_LENGTH * maze->size) + WALL_THICKNESS, WALL_THICKNESS}
     };
+    for(int i = 0; i < 4; i++) addWall(&batch, mazeBorders[i], 1);
+    flushWalls(&batch);
+}
 
-    SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);
-    SDL_RenderFillRects(renderer, mazeBorders, 4);
-
-    // Render vertical walls
-    int x = x_0 + CELL_LENGTH;
-    int y = y_0;
-    for(int i = 0; i < maze->size; i++)
-    {
-        x = x_0 + CELL_LENGTH;
-
-        for(int j = 0; j < maze->size - 1; j++)
-        {
-            if(maze->vWalls[i][j])
-            {
-                SDL_Rect tempRect = {x, y, WALL_THICKNESS, CELL_LENGTH + WALL_THICKNESS};
-                SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);    
-                SDL_RenderFillRect(renderer, &tempRect);
-            }
-            else
-            {
-                SDL_Rect tempRect = {x, y, WALL_THICKNESS, CELL_LENGTH + WALL_THICKNESS};
-                SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);    
-                SDL_RenderDrawRect(renderer, &tempRect);
-            }
+// Draws the whole maze over a white background into the current render target
+static void drawMaze(Maze *maze)
+{
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    SDL_RenderClear(renderer);
+    drawWalls(maze, 0, maze->size - 1, 0, maze->size - 1);
+}
 
-            x += CELL_LENGTH;
-        }
+// Replaces the maze's cached texture with one drawn for the current screen layout; call after resizing
+// Returns the new texture, or NULL if render targets are unsupported and the maze has to be drawn every frame
+SDL_Texture* createMazeTexture(Maze *maze)
+{
+    if(maze->mazeTexture) SDL_DestroyTexture(maze->mazeTexture);
+    maze->mazeTexture = NULL;
+    if(!SDL_RenderTargetSupported(renderer)) return NULL;
 
-        y += CELL_LENGTH;
-    }
+    SDL_Texture* mazeTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if(mazeTexture == NULL) return NULL;
 
-    // Render horizontal walls
-    x = x_0;
-    y = y_0 + CELL_LENGTH;
-    for(int i = 0; i < maze->size - 1; i++)
-    {
-        x = x_0;
+    SDL_SetRenderTarget(renderer, mazeTexture);
+    drawMaze(maze);
+    SDL_SetRenderTarget(renderer, NULL);
 
-        for(int j = 0; j < maze->size; j++)
-        {
-            if(maze->hWalls[i][j])
-            {
-                SDL_Rect tempRect = {x, y, CELL_LENGTH + WALL_THICKNESS, WALL_THICKNESS};
-                SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);  
-                SDL_RenderFillRect(renderer, &tempRect);
-            }
-            else
-            {
-                SDL_Rect tempRect = {x, y, CELL_LENGTH + WALL_THICKNESS, WALL_THICKNESS};
-                SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xFF);  
-                SDL_RenderDrawRect(renderer, &tempRect);
-            }
+    return mazeTexture;
+}
 
-            x += CELL_LENGTH;
-        }
+// Redraws the area of the cached texture covered by one wall slot after it was toggled, along with the
+// neighboring slots that overlap it at the corners
+static void redrawWall(Maze *maze, int i, int j, int vertical)
+{
+    if(!maze->mazeTexture) return;
+
+    SDL_Rect area;
+    if(vertical) area = (SDL_Rect) {x_0 + CELL_LENGTH * (j + 1), y_0 + CELL_LENGTH * i, WALL_THICKNESS, CELL_LENGTH + WALL_THICKNESS};
+    else area = (SDL_Rect) {x_0 + CELL_LENGTH * j, y_0 + CELL_LENGTH * (i + 1), CELL_LENGTH + WALL_THICKNESS, WALL_THICKNESS};
+
+    SDL_SetRenderTarget(renderer, maze->mazeTexture);
+    SDL_RenderSetClipRect(renderer, &area);
+    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+    SDL_RenderFillRect(renderer, &area);
+    drawWalls(maze, i - 1, i + 1, j - 1, j + 1);
+    SDL_RenderSetClipRect(renderer, NULL);
+    SDL_SetRenderTarget(renderer, NULL);
+}
 
-        y += CELL_LENGTH;
-    }
+// Render maze to screen, from the cached texture when there is one
+int renderMaze(Maze *maze)
+{
+    if(maze->mazeTexture) SDL_RenderCopy(renderer, maze->mazeTexture, NULL, NULL);
+    else drawMaze(maze);
 
     return 1;
 }
 
-// Checks if mouse click coincides with a wall and toggles it if it does
-int updateWall(Maze *maze, int mx, int my)
+// Rounds a / b down for any sign of a (b > 0)
+static int floorDivide(int a, int b)
 {
-    // Render vertical walls
-    int x = x_0 + CELL_LENGTH;
-    int y = y_0;
-    for(int i = 0; i < maze->size; i++)
-    {
-        x = x_0 + CELL_LENGTH;
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
 
-        for(int j = 0; j < maze->size - 1; j++)
+// Finds the wall slot under screen point (mx, my) by working out its row and column from the maze layout
+// A vertical slot's click area spans SELECTION_PADDING either side of the wall and is narrower than a cell, so
+// only one column can match, while neighboring slots overlap by WALL_THICKNESS along the wall, so two rows are
+// tried, first one first. Vertical slots take precedence over horizontal ones
+// Returns 1 for vertical wall (i, j), 0 for horizontal wall (i, j), -1 if the point is not on a wall slot
+static int findWall(Maze *maze, int mx, int my, int *i, int *j)
+{
+    int size = maze->size;
+    int dx = mx - x_0, dy = my - y_0;
+
+    // Vertical walls right of row i, column j: x from CELL_LENGTH * (j + 1) - SELECTION_PADDING to
+    // CELL_LENGTH * (j + 1) + WALL_THICKNESS + SELECTION_PADDING (inclusive), y strictly inside
+    // CELL_LENGTH * i to CELL_LENGTH * (i + 1) + WALL_THICKNESS
+    int column = floorDivide(dx + SELECTION_PADDING, CELL_LENGTH);
+    if(column >= 1 && column <= size - 1 && dx <= CELL_LENGTH * column + WALL_THICKNESS + SELECTION_PADDING)
+    {
+        int row = floorDivide(dy, CELL_LENGTH);
+        for(int r = row - 1; r <= row; r++)
         {
-            if(mx >= x - SELECTION_PADDING && mx <= x + WALL_THICKNESS + SELECTION_PADDING && my > y && my < y + CELL_LENGTH + WALL_THICKNESS)
+            if(r >= 0 && r < size && dy > CELL_LENGTH * r && dy < CELL_LENGTH * (r + 1) + WALL_THICKNESS)
             {
-                maze->vWalls[i][j] = !(maze->vWalls[i][j]);
+                *i = r;
+                *j = column - 1;
                 return 1;
             }
-
-            x += CELL_LENGTH;
         }
-
-        y += CELL_LENGTH;
     }
 
-    // Render horizontal walls
-    x = x_0;
-    y = y_0 + CELL_LENGTH;
-    for(int i = 0; i < maze->size - 1; i++)
+    // Horizontal walls below row i, column j: y strictly inside CELL_LENGTH * (i + 1) +/- the padding and wall,
+    // x from CELL_LENGTH * j to CELL_LENGTH * (j + 1) + WALL_THICKNESS (inclusive)
+    int row = floorDivide(dy + SELECTION_PADDING, CELL_LENGTH);
+    if(row >= 1 && row <= size - 1 && dy > CELL_LENGTH * row - SELECTION_PADDING &&
+       dy < CELL_LENGTH * row + WALL_THICKNESS + SELECTION_PADDING)
     {
-        x = x_0;
-
-        for(int j = 0; j < maze->size; j++)
+        column = floorDivide(dx, CELL_LENGTH);
+        for(int c = column - 1; c <= column; c++)
         {
-            if(mx >= x && mx <= x + CELL_LENGTH + WALL_THICKNESS && my > y - SELECTION_PADDING && my < y + WALL_THICKNESS + SELECTION_PADDING)
+            if(c >= 0 && c < size && dx >= CELL_LENGTH * c && dx <= CELL_LENGTH * (c + 1) + WALL_THICKNESS)
             {
-                maze->hWalls[i][j] = !(maze->hWalls[i][j]);
-                return 1;
+                *i = row - 1;
+                *j = c;
+                return 0;
             }
-
-            x += CELL_LENGTH;
         }
+    }
 
-        y += CELL_LENGTH;
+    return -1;
+}
+
+// Sets the wall slot under screen point (mx, my), if any, and redraws it when it changes
+// Returns 1 if a wall changed, 0 otherwise
+static int setWallAt(Maze *maze, int mx, int my, int present)
+{
+    int i, j;
+    int vertical = findWall(maze, mx, my, &i, &j);
+    if(vertical < 0) return 0;
+
+    unsigned char *wall = vertical ? &V_WALL(maze, i, j) : &H_WALL(maze, i, j);
+    if(*wall == present) return 0;
+    *wall = present;
+    redrawWall(maze, i, j, vertical);
+
+    return 1;
+}
+
+// Checks if mouse click coincides with a wall and toggles it if it does
+// Returns the wall's new state (1 if placed, 0 if removed), or -1 if the click missed every wall
+int updateWall(Maze *maze, int mx, int my)
+{
+    int i, j;
+    int vertical = findWall(maze, mx, my, &i, &j);
+    if(vertical < 0) return -1;
+
+    unsigned char *wall = vertical ? &V_WALL(maze, i, j) : &H_WALL(maze, i, j);
+    setWallAt(maze, mx, my, !*wall);
+
+    return *wall;
+}
+
+// Sets every wall slot along the line from (x1, y1) to (x2, y2) to the given state, one pixel at a time so fast
+// drags do not skip walls
+// Returns the number of walls changed
+int paintWalls(Maze *maze, int x1, int y1, int x2, int y2, int present)
+{
+    int dx = x2 - x1, dy = y2 - y1;
+    int steps = abs(dx) > abs(dy) ? abs(dx) : abs(dy);
+    int changed = 0;
+    for(int k = 0; k <= steps; k++)
+    {
+        int x = steps ? x1 + dx * k / steps : x1;
+        int y = steps ? y1 + dy * k / steps : y1;
+        changed += setWallAt(maze, x, y, present);
     }
-}
\ No newline at end of file
+
+    return changed;
+}
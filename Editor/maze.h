@@ -3,17 +3,27 @@
 
 #include <SDL2/SDL.h>
 
+// Wall arrays are heap-allocated to fit the maze size; rows run top to bottom
+// hWalls holds the size - 1 inner rows of horizontal walls (size walls each)
+// vWalls holds the size rows of inner vertical walls (size - 1 walls each)
 typedef struct
 {
     char name[64];
     int size;
     SDL_Texture* mazeTexture;
-    int hWalls [17][16];
-    int vWalls [16][17];
+    unsigned char *hWalls;
+    unsigned char *vWalls;
 } Maze;
 
+// Access horizontal wall below row i, column j and vertical wall right of row i, column j
+#define H_WALL(maze, i, j) ((maze)->hWalls[(i) * (maze)->size + (j)])
+#define V_WALL(maze, i, j) ((maze)->vWalls[(i) * ((maze)->size - 1) + (j)])
+
+int allocateMaze(Maze *maze, int size);
 int loadMaze(Maze* maze, const char *path);
 int updateWall(Maze *maze, int mx, int my);
+int paintWalls(Maze *maze, int x1, int y1, int x2, int y2, int present);
+SDL_Texture* createMazeTexture(Maze *maze);
 int renderMaze(Maze *maze);
 int saveMaze(Maze *maze, const char *path);
 
@@ -0,0 +1,339 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "analysis.h"
+#include "mouse.h"
+
+// Number of mazes a worker claims at once
+#define ANALYSIS_CHUNK 64
+
+// Bit-parallel analysis
+// Every row of the maze is a bitset of cells, as in distance.c: the flood from the start expands a whole
+// wavefront with a few shifts and masks per row word, and the graph counts (edges, dead ends, junctions) come
+// from popcounts of per-row opening masks instead of visiting cells one at a time. Only the shortest path
+// count and the wall followers look at single cells.
+
+// Sets up scratch memory for mazes of the given size
+// Returns 1 on success, 0 if memory could not be allocated
+int initAnalyzer(MazeAnalyzer *analyzer, int size)
+{
+    int rowWords = (size + 63) / 64;
+    size_t rowsWords = (size_t) size * rowWords;
+    *analyzer = (MazeAnalyzer) {size, rowWords};
+    analyzer->memory = malloc(sizeof(uint64_t) * 5 * rowsWords);
+    analyzer->pathCounts = calloc((size_t) size * size, sizeof(double));
+    if(!analyzer->memory || !analyzer->pathCounts)
+    {
+        freeAnalyzer(analyzer);
+        return 0;
+    }
+
+    analyzer->openNorth = analyzer->memory;
+    analyzer->openEast = analyzer->openNorth + rowsWords;
+    analyzer->frontier = analyzer->openEast + rowsWords;
+    analyzer->next = analyzer->frontier + rowsWords;
+    analyzer->visited = analyzer->next + rowsWords;
+    return 1;
+}
+
+void freeAnalyzer(MazeAnalyzer *analyzer)
+{
+    free(analyzer->memory);
+    free(analyzer->pathCounts);
+    *analyzer = (MazeAnalyzer) {0};
+}
+
+static inline int getBit(const uint64_t *row, int x)
+{
+    return (row[x >> 6] >> (x & 63)) & 1;
+}
+
+// Returns the open sides of cell (x, y) as a mask of WALL_NORTH, WALL_EAST, ...; sides on the border are
+// closed whether or not the maze records them
+static inline int getOpenings(const Maze *maze, int x, int y)
+{
+    int open = ~getWalls(maze, x, y) & 0xF;
+    if(y == maze->size - 1) open &= ~WALL_NORTH;
+    if(x == maze->size - 1) open &= ~WALL_EAST;
+    if(y == 0) open &= ~WALL_SOUTH;
+    if(x == 0) open &= ~WALL_WEST;
+    return open;
+}
+
+// Same as isGoal in maze.c, inlined for the per-cell loops
+static inline int inGoal(int size, int x, int y)
+{
+    int lo = (size - 1) / 2, hi = size / 2;
+    return x >= lo && x <= hi && y >= lo && y <= hi;
+}
+
+static const int dx[4] = {0, 1, 0, -1};
+static const int dy[4] = {1, 0, -1, 0};
+
+// Adds up the shortest paths into cell (x, y) from its neighbors in the frontier, which are one cell nearer the
+// start
+static inline double countPaths(const MazeAnalyzer *a, const Maze *maze, int x, int y)
+{
+    // Closed sides are looked up at the cell itself, which is never in the frontier, so no side needs a branch
+    int size = a->size;
+    int open = getOpenings(maze, x, y);
+    double paths = 0;
+    for(int h = 0; h < 4; h++)
+    {
+        int side = (open >> h) & 1;
+        int nx = x + dx[h] * side, ny = y + dy[h] * side;
+        double count = a->pathCounts[ny * size + nx];
+        paths += getBit(&a->frontier[ny * a->rowWords], nx) ? count : 0;
+    }
+    return paths;
+}
+
+// Floods the maze from the start one wavefront at a time, counting shortest paths until the goal is reached
+// and then only marking reachable cells in visited
+static void floodFromStart(MazeAnalyzer *a, const Maze *maze, MazeStats *stats)
+{
+    int size = a->size, w = a->rowWords;
+    size_t rowsBytes = sizeof(uint64_t) * size * w;
+    memset(a->frontier, 0, rowsBytes);
+    memset(a->visited, 0, rowsBytes);
+    a->frontier[0] = a->visited[0] = 1;
+    a->pathCounts[0] = 1;
+
+    stats->shortest = -1;
+    stats->shortestPaths = 0;
+    if(inGoal(size, 0, 0))
+    {
+        stats->shortest = 0;
+        stats->shortestPaths = 1;
+    }
+
+    uint64_t any = 1;
+    for(int d = 1; any; d++)
+    {
+        any = 0;
+        for(int y = 0; y < size; y++)
+        {
+            const uint64_t *row = &a->frontier[y * w];
+            const uint64_t *openEast = &a->openEast[y * w];
+            for(int i = 0; i < w; i++)
+            {
+                uint64_t carryEast = (i > 0) ? (row[i - 1] & openEast[i - 1]) >> 63 : 0;
+                uint64_t carryWest = (i < w - 1) ? row[i + 1] << 63 : 0;
+                uint64_t reached = (((row[i] & openEast[i]) << 1) | carryEast)
+                                 | (((row[i] >> 1) | carryWest) & openEast[i])
+                                 | ((y > 0) ? row[i - w] & a->openNorth[(y - 1) * w + i] : 0)
+                                 | ((y < size - 1) ? row[i + w] & a->openNorth[y * w + i] : 0);
+                reached &= ~a->visited[y * w + i];
+                a->next[y * w + i] = reached;
+                a->visited[y * w + i] |= reached;
+                any |= reached;
+            }
+        }
+
+        // Paths only need counting into the wavefronts up to the first one that reaches the goal
+        if(stats->shortest < 0 && any)
+        {
+            double goalPaths = 0;
+            for(int y = 0; y < size; y++)
+            {
+                for(int i = 0; i < w; i++)
+                {
+                    uint64_t bits = a->next[y * w + i];
+                    while(bits)
+                    {
+                        int x = i * 64 + __builtin_ctzll(bits);
+                        double paths = countPaths(a, maze, x, y);
+                        a->pathCounts[y * size + x] = paths;
+                        if(inGoal(size, x, y)) goalPaths += paths;
+                        bits &= bits - 1;
+                    }
+                }
+            }
+            if(goalPaths > 0)
+            {
+                stats->shortest = d;
+                stats->shortestPaths = goalPaths;
+            }
+        }
+
+        uint64_t *swap = a->frontier;
+        a->frontier = a->next;
+        a->next = swap;
+    }
+}
+
+// Follows the left (hand 0) or right (hand 1) wall from the start facing north, the way leftWallFollower in
+// solver.c does: turn toward the wall side if it is open, otherwise go straight, otherwise turn away
+// Wall following steps through the maze's moves (cell and heading) as a permutation, so a follower that does not
+// reach the goal comes back round to its first move, where it is stopped
+static void followWall(MazeAnalyzer *a, const Maze *maze, int hand, int *moves, int *cells)
+{
+    // Turns to try in order, relative to the heading: 0 straight, 1 right, 2 back, 3 left
+    static const int turns[2][4] = {{3, 0, 1, 2}, {1, 0, 3, 2}};
+    int size = a->size, w = a->rowWords;
+    uint64_t *seen = a->next;
+    memset(seen, 0, sizeof(uint64_t) * size * w);
+    seen[0] = 1;
+
+    int x = 0, y = 0, heading = NORTH;
+    long firstMove = -1;
+    *moves = inGoal(size, 0, 0) ? 0 : -1;
+    for(int m = 1; *moves < 0; m++)
+    {
+        // Rotate the openings so bit 0 is straight ahead, as getRelativeWalls in mouse.c does
+        int open = getOpenings(maze, x, y);
+        int relative = ((open | (open << 4)) >> heading) & 0xF;
+        if(!relative) break;
+        int t = 0;
+        while(!((relative >> turns[hand][t]) & 1)) t++;
+        heading = (heading + turns[hand][t]) & 3;
+
+        x += dx[heading];
+        y += dy[heading];
+        long move = ((long) y * size + x) * 4 + heading;
+        if(move == firstMove) break;
+        if(firstMove < 0) firstMove = move;
+        seen[y * w + (x >> 6)] |= 1ULL << (x & 63);
+        if(inGoal(size, x, y)) *moves = m;
+    }
+
+    *cells = 0;
+    for(size_t i = 0; i < (size_t) size * w; i++) *cells += __builtin_popcountll(seen[i]);
+}
+
+// Computes the structure of a maze; the analyzer must have been set up for the maze's size
+// Returns 1 on success, 0 if the analyzer is for a different size
+int analyzeMaze(MazeAnalyzer *a, const Maze *maze, MazeStats *stats)
+{
+    int size = maze->size, w = a->rowWords;
+    if(size != a->size) return 0;
+    *stats = (MazeStats) {size};
+
+    // Openings out of each cell; walls on the border are closed whether or not the maze records them
+    uint64_t lastMask = (size % 64) ? (1ULL << (size % 64)) - 1 : ~0ULL;
+    for(int y = 0; y < size; y++)
+    {
+        for(int i = 0; i < w; i++)
+        {
+            uint64_t mask = (i == w - 1) ? lastMask : ~0ULL;
+            a->openNorth[y * w + i] = (y < size - 1) ? ~maze->northWalls[y * w + i] & mask : 0;
+            a->openEast[y * w + i] = ~maze->eastWalls[y * w + i] & mask;
+        }
+        a->openEast[y * w + w - 1] &= ~(1ULL << ((size - 1) & 63));
+    }
+
+    floodFromStart(a, maze, stats);
+
+    // Count each cell's openings with a bit-sliced adder over the four opening masks: degree = b0 + 2 b1 + 4 b2
+    long edges = 0;
+    for(int y = 0; y < size; y++)
+    {
+        for(int i = 0; i < w; i++)
+        {
+            uint64_t north = a->openNorth[y * w + i];
+            uint64_t south = (y > 0) ? a->openNorth[(y - 1) * w + i] : 0;
+            uint64_t east = a->openEast[y * w + i];
+            uint64_t west = (east << 1) | ((i > 0) ? a->openEast[y * w + i - 1] >> 63 : 0);
+            uint64_t reached = a->visited[y * w + i];
+
+            uint64_t s1 = north ^ south, c1 = north & south;
+            uint64_t s2 = east ^ west, c2 = east & west;
+            uint64_t b0 = s1 ^ s2, t = s1 & s2;
+            uint64_t b1 = c1 ^ c2 ^ t;
+            uint64_t b2 = (c1 & c2) | (t & (c1 ^ c2));
+
+            stats->reachable += __builtin_popcountll(reached);
+            stats->deadEnds += __builtin_popcountll(b0 & ~b1 & ~b2 & reached);
+            stats->junctions += __builtin_popcountll(((b0 & b1) | b2) & reached);
+            edges += __builtin_popcountll(north & reached) + __builtin_popcountll(east & reached);
+        }
+    }
+
+    // Every open wall between reachable cells is one edge; a tree would have one edge fewer than cells
+    if(__builtin_popcount(getOpenings(maze, 0, 0)) == 1) stats->deadEnds--;
+    stats->loops = edges - stats->reachable + 1;
+    stats->branching = (double) (2 * edges - stats->reachable + 1) / stats->reachable;
+
+    followWall(a, maze, 0, &stats->leftWallMoves, &stats->leftWallCells);
+    followWall(a, maze, 1, &stats->rightWallMoves, &stats->rightWallCells);
+    return 1;
+}
+
+// Maze list shared by all workers; each result is written by the one worker that claimed its maze
+typedef struct
+{
+    Maze *mazes;
+    const MazePack *pack;   // If set, mazes are decoded from the pack instead of taken from mazes
+    MazeStats *stats;
+    long count;
+    atomic_long next;
+} AnalysisQueue;
+
+// Worker thread: claims chunks of mazes until none are left, reusing its analyzer while the size stays the same
+static void *analyzeWorker(void *arg)
+{
+    AnalysisQueue *queue = arg;
+    MazeAnalyzer analyzer = {0};
+    Maze packed = {0};
+
+    while(1)
+    {
+        long first = atomic_fetch_add(&queue->next, ANALYSIS_CHUNK);
+        if(first >= queue->count) break;
+
+        long last = first + ANALYSIS_CHUNK;
+        if(last > queue->count) last = queue->count;
+        for(long i = first; i < last; i++)
+        {
+            Maze *maze = &queue->mazes[i];
+            if(queue->pack)
+            {
+                if(!loadPackedMaze(queue->pack, i, &packed)) continue;
+                maze = &packed;
+            }
+            if(maze->size != analyzer.size)
+            {
+                freeAnalyzer(&analyzer);
+                if(!initAnalyzer(&analyzer, maze->size)) continue;
+            }
+            analyzeMaze(&analyzer, maze, &queue->stats[i]);
+        }
+    }
+
+    freeAnalyzer(&analyzer);
+    freeMaze(&packed);
+    return NULL;
+}
+
+// Analyzes every maze on the given number of threads, storing maze i's results in stats[i]
+// Mazes are taken from the pack if one is given, otherwise from the mazes array; results of mazes that could
+// not be analyzed are left with size 0
+// Returns 1 on success, 0 if memory could not be allocated
+int analyzeMazes(Maze *mazes, const MazePack *pack, MazeStats *stats, long count, int threads)
+{
+    AnalysisQueue queue = {mazes, pack, stats, count};
+    atomic_init(&queue.next, 0);
+    memset(stats, 0, sizeof(MazeStats) * count);
+
+    if(threads < 1) threads = 1;
+    long chunks = (count + ANALYSIS_CHUNK - 1) / ANALYSIS_CHUNK;
+    if(threads > chunks) threads = chunks > 0 ? chunks : 1;
+
+    // The calling thread works too, so only threads - 1 extra threads are started
+    pthread_t *workers = malloc(sizeof(pthread_t) * threads);
+    if(!workers) return 0;
+    int started = 0;
+    for(int i = 1; i < threads; i++)
+    {
+        if(pthread_create(&workers[started], NULL, analyzeWorker, &queue)) break;
+        started++;
+    }
+
+    analyzeWorker(&queue);
+    for(int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+
+    free(workers);
+    return 1;
+}
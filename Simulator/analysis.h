@@ -0,0 +1,46 @@
+#ifndef ANALYSIS_H
+#define ANALYSIS_H
+
+#include <stdint.h>
+#include "maze.h"
+#include "pack.h"
+
+// Structure of a maze as seen from the start cell, computed from its walls alone. Counts cover the cells
+// reachable from the start; the maze's corridors form a graph with a node per cell and an edge per open wall
+typedef struct
+{
+    int size;
+    int reachable;              // Cells reachable from the start
+    int deadEnds;               // Reachable cells with exactly one opening, not counting the start
+    int junctions;              // Reachable cells with three or four openings
+    int loops;                  // Independent loops (cyclomatic number: edges - cells + 1)
+    int shortest;               // Fewest cells moved from the start to the goal, -1 if it cannot be reached
+    double shortestPaths;       // Number of distinct shortest paths to the goal, 0 if it cannot be reached
+    double branching;           // Mean number of ways on from a reachable cell, not counting the way in
+    int leftWallMoves;          // Cells a left wall follower moves to reach the goal, -1 if it never does
+    int leftWallCells;          // Distinct cells the left wall follower visits before it reaches the goal or loops
+    int rightWallMoves;         // Same for a right wall follower
+    int rightWallCells;
+} MazeStats;
+
+// Scratch memory for analyzing mazes of one size, so many mazes can be analyzed back to back without
+// allocating; bitsets hold one row of rowWords words per maze row
+typedef struct
+{
+    int size;
+    int rowWords;
+    uint64_t *memory;
+    uint64_t *openNorth;        // Bit x of row y: the way north out of (x, y) is open
+    uint64_t *openEast;         // Bit x of row y: the way east out of (x, y) is open
+    uint64_t *frontier;         // Cells first reached at the current distance from the start
+    uint64_t *next;             // Cells first reached at the next distance
+    uint64_t *visited;          // Cells reached so far
+    double *pathCounts;         // Shortest paths from the start to each cell reached so far
+} MazeAnalyzer;
+
+int initAnalyzer(MazeAnalyzer *analyzer, int size);
+void freeAnalyzer(MazeAnalyzer *analyzer);
+int analyzeMaze(MazeAnalyzer *analyzer, const Maze *maze, MazeStats *stats);
+int analyzeMazes(Maze *mazes, const MazePack *pack, MazeStats *stats, long count, int threads);
+
+#endif
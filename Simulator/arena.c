@@ -0,0 +1,119 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "arena.h"
+
+#define ARENA_ALIGNMENT 16          // Alignment of every allocation (bytes)
+#define MIN_BLOCK_SIZE 4096         // Smallest block allocated for an arena without a budget (bytes)
+
+// Header size rounded up so a block's data starts aligned
+#define HEADER_SIZE ((sizeof(ArenaBlock) + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT)
+
+// Sets up an empty arena with the given budget (bytes, 0 for no limit); memory is allocated on first use
+void initArena(Arena *arena, size_t budget)
+{
+    *arena = (Arena) {NULL, budget};
+}
+
+// Adds a block with room for at least the given number of bytes
+// Returns 1 on success, 0 if memory could not be allocated
+static int addBlock(Arena *arena, size_t size)
+{
+    ArenaBlock *block = malloc(HEADER_SIZE + size);
+    if(!block) return 0;
+
+    *block = (ArenaBlock) {arena->blocks, size, 0};
+    arena->blocks = block;
+    return 1;
+}
+
+// Allocates memory that lasts until the arena is reset, aligned for any type
+// Returns a pointer to the memory, or NULL if it would go over the budget or could not be allocated
+void *arenaAlloc(Arena *arena, size_t size)
+{
+    size = (size + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+    if(arena->budget && arena->used + size > arena->budget)
+    {
+        arena->exceeded = 1;
+        return NULL;
+    }
+
+    // A budgeted arena takes its whole budget as one block; otherwise blocks grow as needed, at least doubling
+    ArenaBlock *block = arena->blocks;
+    if(!block || block->size - block->used < size)
+    {
+        size_t blockSize = arena->budget;
+        if(!blockSize)
+        {
+            blockSize = block ? block->size * 2 : MIN_BLOCK_SIZE;
+            while(blockSize < size) blockSize *= 2;
+        }
+        if(!addBlock(arena, blockSize)) return NULL;
+        block = arena->blocks;
+    }
+
+    void *memory = (char *) block + HEADER_SIZE + block->used;
+    block->used += size;
+    arena->used += size;
+    arena->allocations++;
+    return memory;
+}
+
+// Frees everything allocated since the last reset, keeping the memory for the next run
+// If the last run needed more than one block, they are replaced by a single block large enough for all of
+// them, so later resets are a pointer move
+void resetArena(Arena *arena)
+{
+    ArenaBlock *block = arena->blocks;
+    if(block && block->next)
+    {
+        size_t total = 0;
+        while(block)
+        {
+            ArenaBlock *next = block->next;
+            total += block->size;
+            free(block);
+            block = next;
+        }
+        arena->blocks = NULL;
+        addBlock(arena, total);
+    }
+    if(arena->blocks) arena->blocks->used = 0;
+
+    arena->used = 0;
+    arena->allocations = 0;
+    arena->exceeded = 0;
+}
+
+// Frees all of the arena's memory; the arena keeps its budget and can be used again
+void freeArena(Arena *arena)
+{
+    ArenaBlock *block = arena->blocks;
+    while(block)
+    {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    initArena(arena, arena->budget);
+}
+
+// Reads a memory size given in bytes, or in kilobytes or megabytes with a K or M suffix (e.g. 2K, 8KB, 1M)
+// Returns the size in bytes, or -1 if the text is not a size
+long parseMemorySize(const char *text)
+{
+    char *end;
+    long size = strtol(text, &end, 10);
+    if(end == text || size < 0) return -1;
+
+    long unit = 1;
+    if(*end == 'k' || *end == 'K') unit = 1024;
+    else if(*end == 'm' || *end == 'M') unit = 1024 * 1024;
+    if(unit > 1)
+    {
+        end++;
+        if(*end == 'b' || *end == 'B') end++;
+    }
+    if(*end) return -1;
+
+    return size * unit;
+}
@@ -0,0 +1,33 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+// Block of memory an arena hands out; the first bytes of each block hold this header
+typedef struct ArenaBlock
+{
+    struct ArenaBlock *next;    // Older block, NULL for the first
+    size_t size;                // Bytes available after the header
+    size_t used;                // Bytes handed out from this block
+} ArenaBlock;
+
+// Bump allocator for solver state that lasts one run. Allocations are never freed one by one; resetting the
+// arena for the next run only moves its pointer back, so runs cost no malloc or free calls once it has grown
+// A budget caps the bytes a run can allocate, emulating the RAM of the microcontroller on a real mouse;
+// allocations that would go over it fail and are reported
+typedef struct
+{
+    ArenaBlock *blocks;         // Newest block first
+    size_t budget;              // Most bytes a run may allocate, 0 for no limit
+    size_t used;                // Bytes allocated since the last reset, including alignment; the run's high-water mark
+    long allocations;           // Allocations made since the last reset
+    int exceeded;               // 1 if an allocation was refused for going over the budget since the last reset
+} Arena;
+
+void initArena(Arena *arena, size_t budget);
+void *arenaAlloc(Arena *arena, size_t size);
+void resetArena(Arena *arena);
+void freeArena(Arena *arena);
+long parseMemorySize(const char *text);
+
+#endif
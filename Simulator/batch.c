@@ -0,0 +1,393 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "maze.h"
+#include "mouse.h"
+#include "solver.h"
+#include "simulate.h"
+#include "runner.h"
+#include "pack.h"
+#include "symmetry.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazeDirectory = "../Mazes/";  // Path to maze folder
+char *packPath = NULL;              // Pack file to take mazes from instead of the maze folder
+long maxSteps = 100000;             // Maximum number of solver decisions per run
+long repeat = 1;                    // Number of times each (maze, solver, start) run is queued
+int threads = 0;                    // Number of worker threads, 0 to use one per core
+int solverIndex = -1;               // Index of the only solver to run, -1 to run every solver
+int cornerStarts = 0;               // 1 to start from all eight corner configurations instead of (0, 0) facing north
+int csv = 0;                        // 1 to print one CSV line per run
+int timed = 0;                      // 1 to time runs with the motion model
+MotionProfile motionProfile;        // Motion profile runs are timed with
+char *traceDirectory = NULL;        // Folder to record each run's trace to, NULL to not record traces
+long memoryBudget = 0;              // Memory each solver may allocate in a run (bytes), 0 for no limit
+int symmetries = 0;                 // 1 to also run every maze in its 7 other rotations and reflections
+
+unsigned long long checksumJobs(RunJob *jobs, long count);
+void printSymmetryReport(RunJob *jobs, long count);
+void printUsage(const char *program);
+
+// MAIN
+// Runs every (maze, solver, start) combination on all cores and reports totals and a results checksum
+int main(int argc, char** argv)
+{
+    motionProfile = defaultMotionProfile;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--steps") && i + 1 < argc) maxSteps = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--dir") && i + 1 < argc) mazeDirectory = argv[++i];
+        else if(!strcmp(argv[i], "--pack") && i + 1 < argc) packPath = argv[++i];
+        else if(!strcmp(argv[i], "--plugin") && i + 1 < argc)
+        {
+            if(loadSolverPlugin(argv[++i]) < 0) return -1;
+        }
+        else if(!strcmp(argv[i], "--csv")) csv = 1;
+        else if(!strcmp(argv[i], "--symmetries")) symmetries = 1;
+        else if(!strcmp(argv[i], "--trace") && i + 1 < argc) traceDirectory = argv[++i];
+        else if(!strcmp(argv[i], "--memory") && i + 1 < argc)
+        {
+            memoryBudget = parseMemorySize(argv[++i]);
+            if(memoryBudget < 0)
+            {
+                printf("Error: invalid memory budget %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "--motion") && i + 1 < argc)
+        {
+            timed = 1;
+            i++;
+            if(strcmp(argv[i], "default") && !parseMotionProfile(argv[i], &motionProfile)) return -1;
+        }
+        else if(!strcmp(argv[i], "--solver") && i + 1 < argc)
+        {
+            solverIndex = findOrLoadSolver(argv[++i]);
+            if(solverIndex < 0)
+            {
+                printf("Error: unknown solver %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "--starts") && i + 1 < argc)
+        {
+            i++;
+            if(!strcmp(argv[i], "corners")) cornerStarts = 1;
+            else if(!strcmp(argv[i], "default")) cornerStarts = 0;
+            else
+            {
+                printf("Error: unknown start set %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+
+    if(maxSteps < 1 || repeat < 1 || threads < 0)
+    {
+        printf("Error: step limit and repeat count must be positive and thread count must not be negative\n");
+        return -1;
+    }
+    if(threads == 0) threads = getCoreCount();
+    if(traceDirectory && access(traceDirectory, W_OK))
+    {
+        printf("Error: trace folder %s does not exist or is not writable\n", traceDirectory);
+        return -1;
+    }
+
+    // Maze paths are appended to the folder path, so make sure it ends with a separator
+    size_t length = strlen(mazeDirectory);
+    if(length && mazeDirectory[length - 1] != '/')
+    {
+        char *directory = malloc(length + 2);
+        sprintf(directory, "%s/", mazeDirectory);
+        mazeDirectory = directory;
+    }
+
+    // Load every maze up front and share them read-only between workers, or leave pack mazes for the workers
+    // to decode as they go
+    Maze *mazes = NULL;
+    char **names = NULL;
+    MazePack pack = {0};
+    int loaded;
+    if(packPath)
+    {
+        if(!openPack(&pack, packPath)) return -1;
+        loaded = pack.count;
+    }
+    else
+    {
+        loaded = loadMazes(&mazes, &names);
+        if(loaded <= 0)
+        {
+            printf("Error: no valid maze files found in %s\n", mazeDirectory);
+            return -1;
+        }
+    }
+
+    // Build the job list in a fixed order so job i means the same run whatever the thread count; the variants of
+    // one run in the rotated and reflected mazes are consecutive
+    int firstSolver = solverIndex < 0 ? 0 : solverIndex;
+    int lastSolver = solverIndex < 0 ? solverCount - 1 : solverIndex;
+    int variantCount = symmetries ? SYMMETRY_COUNT : 1;
+    long jobCount = 0;
+    for(int m = 0; m < loaded; m++)
+    {
+        jobCount += (cornerStarts ? 8 : 1) * (lastSolver - firstSolver + 1) * repeat * variantCount;
+    }
+
+    RunJob *jobs = calloc(jobCount, sizeof(RunJob));
+    if(!jobs)
+    {
+        printf("Error: unable to allocate %ld jobs\n", jobCount);
+        return -1;
+    }
+
+    long j = 0;
+    for(int m = 0; m < loaded; m++)
+    {
+        StartConfig starts[8] = {{0, 0, NORTH}};
+        int size = packPath ? (int) pack.entries[m].size : mazes[m].size;
+        int startCount = cornerStarts ? getCornerStarts(size, starts) : 1;
+        for(int s = firstSolver; s <= lastSolver; s++)
+        {
+            for(int c = 0; c < startCount; c++)
+            {
+                for(long r = 0; r < repeat; r++)
+                {
+                    for(int v = 0; v < variantCount; v++)
+                    {
+                        jobs[j].maze = m;
+                        jobs[j].solver = s;
+                        jobs[j].symmetry = v;
+                        jobs[j].start = starts[c];
+                        j++;
+                    }
+                }
+            }
+        }
+    }
+
+    RunOptions options = {maxSteps, timed ? &motionProfile : NULL, traceDirectory, memoryBudget};
+    double start = getTime();
+    if(!runJobs(mazes, packPath ? &pack : NULL, jobs, jobCount, &options, threads))
+    {
+        printf("Error: unable to start batch\n");
+        return -1;
+    }
+    double elapsed = getTime() - start;
+
+    // Report results in job order; failed jobs have no results and are only counted
+    long failed = 0, goals = 0, crashes = 0, decisions = 0, overBudget = 0, memoryPeak = 0;
+    double runTime = 0;
+    if(csv)
+    {
+        printf("maze,solver,start_x,start_y,start_heading,reached_goal,crashed,steps,moves,turns,cells_visited,"
+               "memory_bytes,allocations,over_budget%s%s\n", timed ? ",run_time_s" : "", symmetries ? ",symmetry" : "");
+    }
+    for(long i = 0; i < jobCount; i++)
+    {
+        RunJob *job = &jobs[i];
+        if(job->failed)
+        {
+            failed++;
+            continue;
+        }
+        goals += job->stats.reachedGoal;
+        crashes += job->stats.crashed;
+        decisions += job->stats.steps;
+        runTime += job->stats.runTime;
+        overBudget += job->stats.overBudget;
+        if(job->stats.memoryUsed > memoryPeak) memoryPeak = job->stats.memoryUsed;
+        if(csv)
+        {
+            const char *name = names ? names[job->maze] : pack.entries[job->maze].file[0] ?
+                               pack.entries[job->maze].file : pack.entries[job->maze].name;
+            printf("%s,%s,%d,%d,%d,%d,%d,%ld,%ld,%ld,%ld", name, solvers[job->solver].name,
+                   job->start.x, job->start.y, job->start.heading, job->stats.reachedGoal, job->stats.crashed,
+                   job->stats.steps, job->stats.moves, job->stats.turns, job->stats.cellsVisited);
+            printf(",%ld,%ld,%d", job->stats.memoryUsed, job->stats.allocations, job->stats.overBudget);
+            if(timed) printf(",%.3f", job->stats.runTime);
+            if(symmetries) printf(",%s", symmetryNames[job->symmetry]);
+            printf("\n");
+        }
+    }
+
+    if(!csv)
+    {
+        printf("Mazes: %d\n", loaded);
+        printf("Runs: %ld\n", jobCount);
+        if(failed) printf("Failed: %ld (not counted below)\n", failed);
+        printf("Threads: %d\n", threads);
+        printf("Reached goal: %ld\n", goals);
+        printf("Crashed: %ld\n", crashes);
+        printf("Decisions: %ld\n", decisions);
+        printf("Solver memory: %ld bytes at most", memoryPeak);
+        if(memoryBudget) printf(" (budget %ld bytes, exceeded in %ld runs)", memoryBudget, overBudget);
+        printf("\n");
+        if(timed && jobCount > failed)
+        {
+            printf("Simulated run time: %.3f s (%.3f s per run)\n", runTime, runTime / (jobCount - failed));
+        }
+        printf("Elapsed: %.6f s\n", elapsed);
+        if(elapsed > 0)
+        {
+            printf("Throughput: %.0f runs/s, %.0f decisions/s\n", (jobCount - failed) / elapsed, decisions / elapsed);
+        }
+        printf("Checksum: %016llx\n", checksumJobs(jobs, jobCount));
+        if(symmetries) printSymmetryReport(jobs, jobCount);
+    }
+
+    if(packPath) closePack(&pack);
+    else
+    {
+        for(int m = 0; m < loaded; m++)
+        {
+            freeMaze(&mazes[m]);
+            free(names[m]);
+        }
+        free(names);
+        free(mazes);
+    }
+    free(jobs);
+    if(failed)
+    {
+        // CSV output only lists the runs that were set up; the exit status reports the rest
+        if(!csv) printf("Error: %ld of %ld runs could not be set up\n", failed, jobCount);
+        return -1;
+    }
+    return 0;
+}
+
+// Hashes every job's inputs and results (except timing) so runs with different thread counts can be compared
+unsigned long long checksumJobs(RunJob *jobs, long count)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for(long i = 0; i < count; i++)
+    {
+        RunJob *job = &jobs[i];
+        if(job->failed) continue;
+        long values[10] = {job->maze, job->solver, job->start.x, job->start.y, job->start.heading,
+                           job->stats.steps, job->stats.moves, job->stats.turns, job->stats.cellsVisited,
+                           job->stats.reachedGoal * 2 + job->stats.crashed};
+        for(int v = 0; v < 10; v++)
+        {
+            hash ^= (unsigned long long) values[v];
+            hash *= 1099511628211ULL;
+        }
+        if(symmetries)
+        {
+            hash ^= (unsigned long long) job->symmetry;
+            hash *= 1099511628211ULL;
+        }
+    }
+
+    return hash;
+}
+
+// Prints results per maze symmetry, then per solver the worst and best case over the symmetries of each run, so
+// solvers whose results depend on which way the maze is turned stand out. A run is orientation-sensitive if its
+// variants do not all end the same way after the same numbers of decisions, moves and turns
+void printSymmetryReport(RunJob *jobs, long count)
+{
+    long runs[SYMMETRY_COUNT] = {0}, goals[SYMMETRY_COUNT] = {0}, crashes[SYMMETRY_COUNT] = {0};
+    double decisions[SYMMETRY_COUNT] = {0};
+    for(long i = 0; i < count; i++)
+    {
+        if(jobs[i].failed) continue;
+        int v = jobs[i].symmetry;
+        runs[v]++;
+        goals[v] += jobs[i].stats.reachedGoal;
+        crashes[v] += jobs[i].stats.crashed;
+        decisions[v] += jobs[i].stats.steps;
+    }
+
+    printf("\n%-16s %8s %8s %8s %10s\n", "symmetry", "runs", "goal", "crashed", "decisions");
+    for(int v = 0; v < SYMMETRY_COUNT; v++)
+    {
+        printf("%-16s %8ld %8ld %8ld %10.1f\n", symmetryNames[v], runs[v], goals[v], crashes[v],
+               runs[v] ? decisions[v] / runs[v] : 0);
+    }
+
+    // Per solver: runs that reach the goal in every orientation, runs that only reach it in some, sensitive runs,
+    // and the mean decisions of the worst and best orientation of each run
+    long *groups = calloc(solverCount * 4, sizeof(long));
+    double *extremes = calloc(solverCount * 2, sizeof(double));
+    if(!groups || !extremes)
+    {
+        printf("Error: unable to allocate symmetry report\n");
+        free(groups);
+        free(extremes);
+        return;
+    }
+    for(long i = 0; i + SYMMETRY_COUNT <= count; i += SYMMETRY_COUNT)
+    {
+        RunJob *group = &jobs[i];
+        int goal = 0, sensitive = 0, complete = 1;
+        for(int v = 0; v < SYMMETRY_COUNT; v++) complete &= !group[v].failed;
+        if(!complete) continue;
+        long worst = group[0].stats.steps, best = group[0].stats.steps;
+        for(int v = 0; v < SYMMETRY_COUNT; v++)
+        {
+            goal += group[v].stats.reachedGoal;
+            const SimStats *a = &group[v].stats, *b = &group[0].stats;
+            if(a->reachedGoal != b->reachedGoal || a->crashed != b->crashed || a->steps != b->steps ||
+               a->moves != b->moves || a->turns != b->turns)
+            {
+                sensitive = 1;
+            }
+            if(group[v].stats.steps > worst) worst = group[v].stats.steps;
+            if(group[v].stats.steps < best) best = group[v].stats.steps;
+        }
+
+        long *totals = &groups[group->solver * 4];
+        totals[0]++;
+        totals[1] += goal == SYMMETRY_COUNT;
+        totals[2] += goal && goal < SYMMETRY_COUNT;
+        totals[3] += sensitive;
+        extremes[group->solver * 2] += worst;
+        extremes[group->solver * 2 + 1] += best;
+    }
+
+    printf("\n%-16s %8s %8s %8s %10s %10s %10s\n", "solver", "runs", "goal-all", "goal-some", "sensitive", "worst",
+           "best");
+    for(int s = 0; s < solverCount; s++)
+    {
+        long *totals = &groups[s * 4];
+        if(!totals[0]) continue;
+        printf("%-16s %8ld %8ld %8ld %10ld %10.1f %10.1f\n", solvers[s].name, totals[0], totals[1], totals[2],
+               totals[3], extremes[s * 2] / totals[0], extremes[s * 2 + 1] / totals[0]);
+    }
+
+    free(groups);
+    free(extremes);
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--dir PATH | --pack FILE] [--plugin FILE]... [--solver NAME] [--starts default|corners] [--repeat N] [--threads N] [--steps N] [--motion SETTINGS] [--memory BYTES] [--trace DIR] [--symmetries] [--csv]\n", program);
+    printf("  --dir PATH       folder of maze files to run (default ../Mazes/)\n");
+    printf("  --pack FILE      run the mazes in this pack file instead of a folder\n");
+    printf("  --plugin FILE    also run the solver plugin in this shared object\n");
+    printf("  --solver NAME    only run this solver, given by name or plugin file (default: every solver)\n");
+    printf("  --starts SET     default: start at (0, 0) facing north; corners: all eight corner starts\n");
+    printf("  --repeat N       queue each run N times (default 1)\n");
+    printf("  --threads N      worker threads (default: one per core)\n");
+    printf("  --steps N        stop each run after N solver decisions (default 100000)\n");
+    printf("  --motion SETTINGS  time runs with the motion model: default, or settings such as speed=2,accel=5\n");
+    printf("                   (cell, speed, accel, decel, turnrate, turnaccel and step; see motion.c)\n");
+    printf("  --memory BYTES   cap the memory a solver may allocate in a run, e.g. 2K or 8KB (default: no limit)\n");
+    printf("  --trace DIR      record each run's decisions to DIR/run_<job>.trace (see tracetool)\n");
+    printf("  --symmetries     also run every maze in its 7 other rotations and reflections, and report each\n");
+    printf("                   orientation and the worst case\n");
+    printf("  --csv            print one CSV line per run instead of totals\n");
+}
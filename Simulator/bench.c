@@ -0,0 +1,192 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "maze.h"
+#include "mouse.h"
+#include "solver.h"
+#include "simulate.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazeDirectory = "../Mazes/";  // Path to maze folder
+long maxSteps = 100000;             // Maximum number of solver decisions per run
+long repeat = 20;                   // Number of timed runs per maze and solver
+long memoryBudget = 0;              // Memory each solver may allocate in a run (bytes), 0 for no limit
+
+// Output formats
+typedef enum Format {TABLE, CSV, JSON} Format;
+Format format = TABLE;
+
+// Result of running one solver on one maze
+typedef struct
+{
+    char maze[256];
+    const char *solver;
+    int size;
+    SimStats stats;
+    double totalTime;   // Wall-clock time of all repeated runs (seconds)
+    long totalSteps;    // Solver decisions made in all repeated runs
+} BenchResult;
+
+void printResults(BenchResult *results, int count);
+void printUsage(const char *program);
+
+// MAIN
+// Runs every registered solver on every maze in the maze folder and reports solver quality and CPU cost
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--steps") && i + 1 < argc) maxSteps = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--dir") && i + 1 < argc) mazeDirectory = argv[++i];
+        else if(!strcmp(argv[i], "--plugin") && i + 1 < argc)
+        {
+            if(loadSolverPlugin(argv[++i]) < 0) return -1;
+        }
+        else if(!strcmp(argv[i], "--memory") && i + 1 < argc)
+        {
+            memoryBudget = parseMemorySize(argv[++i]);
+            if(memoryBudget < 0)
+            {
+                printf("Error: invalid memory budget %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "--csv")) format = CSV;
+        else if(!strcmp(argv[i], "--json")) format = JSON;
+        else
+        {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+
+    if(maxSteps < 1 || repeat < 1)
+    {
+        printf("Error: step limit and repeat count must be positive\n");
+        return -1;
+    }
+
+    // Maze paths are appended to the folder path, so make sure it ends with a separator
+    size_t length = strlen(mazeDirectory);
+    if(length && mazeDirectory[length - 1] != '/')
+    {
+        char *directory = malloc(length + 2);
+        sprintf(directory, "%s/", mazeDirectory);
+        mazeDirectory = directory;
+    }
+
+    char **names;
+    int mazeCount = listMazes(&names);
+    if(mazeCount <= 0)
+    {
+        printf("Error: no maze files found in %s\n", mazeDirectory);
+        return -1;
+    }
+
+    BenchResult *results = calloc((size_t) mazeCount * solverCount, sizeof(BenchResult));
+    if(!results) return -1;
+
+    // Run each solver on each maze; the first run gives the quality metrics, all runs give the timing
+    mazeMessages = 0;
+    int count = 0;
+    Maze maze = {0};
+    SimContext context;
+    StartConfig start = {0, 0, NORTH};
+    for(int m = 0; m < mazeCount; m++)
+    {
+        if(!loadMaze(&maze, names[m])) continue;
+
+        for(int s = 0; s < solverCount; s++)
+        {
+            BenchResult *result = &results[count++];
+            strncpy(result->maze, names[m], sizeof(result->maze) - 1);
+            result->solver = solvers[s].name;
+            result->size = maze.size;
+            initContext(&context, &maze, s);
+            setSolverBudget(&context.state, memoryBudget);
+
+            for(long r = 0; r < repeat; r++)
+            {
+                SimStats stats;
+                startRun(&context, start);
+                simulate(&context.mouse, maxSteps, &stats);
+                if(r == 0) result->stats = stats;
+                result->totalTime += stats.elapsed;
+                result->totalSteps += stats.steps;
+            }
+            freeContext(&context);
+        }
+    }
+
+    printResults(results, count);
+
+    freeMaze(&maze);
+    for(int m = 0; m < mazeCount; m++) free(names[m]);
+    free(names);
+    free(results);
+    return 0;
+}
+
+// Prints results as an aligned table, CSV or JSON
+void printResults(BenchResult *results, int count)
+{
+    if(format == TABLE)
+    {
+        printf("%-24s %-18s %5s %5s %8s %8s %8s %6s %12s %14s %10s %7s\n", "maze", "solver", "size", "goal",
+               "steps", "moves", "turns", "cells", "time (ms)", "ns/decision", "memory (B)", "allocs");
+    }
+    else if(format == CSV)
+    {
+        printf("maze,solver,size,reached_goal,steps,moves,turns,cells_visited,time_ms,ns_per_decision,memory_bytes,"
+               "allocations,over_budget\n");
+    }
+    else printf("[\n");
+
+    for(int i = 0; i < count; i++)
+    {
+        BenchResult *r = &results[i];
+        double timeMs = r->totalTime / repeat * 1e3;
+        double nsPerDecision = r->totalSteps ? r->totalTime / r->totalSteps * 1e9 : 0;
+
+        if(format == TABLE)
+        {
+            printf("%-24s %-18s %5d %5s %8ld %8ld %8ld %6ld %12.4f %14.1f %10ld %7ld%s\n", r->maze, r->solver,
+                   r->size, r->stats.reachedGoal ? "yes" : "no", r->stats.steps, r->stats.moves, r->stats.turns,
+                   r->stats.cellsVisited, timeMs, nsPerDecision, r->stats.memoryUsed, r->stats.allocations,
+                   r->stats.overBudget ? "  over budget" : "");
+        }
+        else if(format == CSV)
+        {
+            printf("%s,%s,%d,%d,%ld,%ld,%ld,%ld,%.6f,%.2f,%ld,%ld,%d\n", r->maze, r->solver, r->size,
+                   r->stats.reachedGoal, r->stats.steps, r->stats.moves, r->stats.turns, r->stats.cellsVisited, timeMs,
+                   nsPerDecision, r->stats.memoryUsed, r->stats.allocations, r->stats.overBudget);
+        }
+        else
+        {
+            printf("  {\"maze\": \"%s\", \"solver\": \"%s\", \"size\": %d, \"reached_goal\": %s, \"steps\": %ld, "
+                   "\"moves\": %ld, \"turns\": %ld, \"cells_visited\": %ld, \"time_ms\": %.6f, \"ns_per_decision\": %.2f, "
+                   "\"memory_bytes\": %ld, \"allocations\": %ld, \"over_budget\": %s}%s\n",
+                   r->maze, r->solver, r->size, r->stats.reachedGoal ? "true" : "false", r->stats.steps, r->stats.moves,
+                   r->stats.turns, r->stats.cellsVisited, timeMs, nsPerDecision, r->stats.memoryUsed,
+                   r->stats.allocations, r->stats.overBudget ? "true" : "false", (i < count - 1) ? "," : "");
+        }
+    }
+
+    if(format == JSON) printf("]\n");
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--dir PATH] [--plugin FILE]... [--steps N] [--repeat N] [--memory BYTES] [--csv | --json]\n",
+           program);
+    printf("  --dir PATH     folder of maze files to run (default ../Mazes/)\n");
+    printf("  --plugin FILE  also run the solver plugin in this shared object\n");
+    printf("  --steps N      stop each run after N solver decisions (default 100000)\n");
+    printf("  --repeat N     timed runs per maze and solver (default 20)\n");
+    printf("  --memory BYTES cap the memory each solver may allocate in a run, e.g. 2K or 8KB (default: no limit)\n");
+    printf("  --csv          print results as CSV\n");
+    printf("  --json         print results as JSON\n");
+}
@@ -0,0 +1,266 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "maze.h"
+#include "pack.h"
+#include "symmetry.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazeDirectory = "../Mazes/";  // Path to maze folder
+char *packPath = NULL;              // Pack file to take mazes from instead of the maze folder
+char *outPath = NULL;               // Pack file to write the unique mazes to
+int removeDuplicates = 0;           // 1 to delete duplicate maze files from the maze folder
+int summaryOnly = 0;                // 1 to print only totals
+
+// Output formats
+typedef enum Format {TABLE, CSV, JSON} Format;
+Format format = TABLE;
+
+// Mazes seen so far, indexed by canonical hash; mazes with equal hashes are chained so a hash collision between
+// different mazes cannot hide either of them
+typedef struct
+{
+    int capacity;                   // Slots, a power of two
+    int *slots;                     // First maze with the slot's hash, -1 if empty
+    uint64_t *hashes;               // Canonical hash of each maze
+    int *next;                      // Next unique maze with the same hash, -1 at the end of the chain
+} MazeIndex;
+
+// Mazes of the folder or pack, decoded from the pack on demand
+Maze *mazes = NULL;
+char **names = NULL;
+MazePack pack = {0};
+
+const char *getName(int m);
+const Maze *getMaze(int m, Maze *scratch);
+void printDuplicate(int duplicate, int original, int symmetry, int first);
+void printUsage(const char *program);
+
+// MAIN
+// Finds mazes in the maze folder or a pack that are rotations or reflections of an earlier maze, optionally
+// deleting them or writing the unique mazes to a new pack
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--dir") && i + 1 < argc) mazeDirectory = argv[++i];
+        else if(!strcmp(argv[i], "--pack") && i + 1 < argc) packPath = argv[++i];
+        else if(!strcmp(argv[i], "--out") && i + 1 < argc) outPath = argv[++i];
+        else if(!strcmp(argv[i], "--remove")) removeDuplicates = 1;
+        else if(!strcmp(argv[i], "--summary")) summaryOnly = 1;
+        else if(!strcmp(argv[i], "--csv")) format = CSV;
+        else if(!strcmp(argv[i], "--json")) format = JSON;
+        else
+        {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+    if(removeDuplicates && packPath)
+    {
+        printf("Error: --remove only applies to maze folders; use --out to write a pack without duplicates\n");
+        return -1;
+    }
+
+    // Maze paths are appended to the folder path, so make sure it ends with a separator
+    size_t length = strlen(mazeDirectory);
+    if(length && mazeDirectory[length - 1] != '/')
+    {
+        char *directory = malloc(length + 2);
+        sprintf(directory, "%s/", mazeDirectory);
+        mazeDirectory = directory;
+    }
+
+    int loaded;
+    if(packPath)
+    {
+        if(!openPack(&pack, packPath)) return -1;
+        loaded = pack.count;
+    }
+    else
+    {
+        loaded = loadMazes(&mazes, &names);
+        if(loaded <= 0)
+        {
+            printf("Error: no valid maze files found in %s\n", mazeDirectory);
+            return -1;
+        }
+    }
+
+    MazeIndex index = {0};
+    index.capacity = 16;
+    while(index.capacity < 2 * loaded) index.capacity <<= 1;
+    index.slots = malloc(sizeof(int) * index.capacity);
+    index.hashes = malloc(sizeof(uint64_t) * (loaded > 0 ? loaded : 1));
+    index.next = malloc(sizeof(int) * (loaded > 0 ? loaded : 1));
+    int *originals = malloc(sizeof(int) * (loaded > 0 ? loaded : 1));
+    if(!index.slots || !index.hashes || !index.next || !originals)
+    {
+        printf("Error: unable to allocate index for %d mazes\n", loaded);
+        return -1;
+    }
+    memset(index.slots, -1, sizeof(int) * index.capacity);
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if(!summaryOnly)
+    {
+        if(format == TABLE) printf("%-24s %-24s %s\n", "duplicate", "original", "symmetry");
+        else if(format == CSV) printf("duplicate,original,symmetry\n");
+        else printf("[\n");
+    }
+
+    // Each maze is compared in full against the earlier unique mazes with the same canonical hash
+    Maze scratch = {0}, other = {0};
+    int unique = 0, duplicates = 0, failed = 0;
+    for(int m = 0; m < loaded; m++)
+    {
+        originals[m] = -1;
+        index.next[m] = -1;
+        const Maze *maze = getMaze(m, &scratch);
+        uint64_t hash = maze ? getCanonicalHash(maze, NULL) : 0;
+        index.hashes[m] = hash;
+        if(!hash)
+        {
+            failed++;
+            continue;
+        }
+
+        int mask = index.capacity - 1, slot = hash & mask;
+        while(index.slots[slot] >= 0 && index.hashes[index.slots[slot]] != hash) slot = (slot + 1) & mask;
+
+        int symmetry = -1, last = -1;
+        for(int u = index.slots[slot]; u >= 0 && symmetry < 0; u = index.next[u])
+        {
+            const Maze *original = getMaze(u, &other);
+            if(original) symmetry = findSymmetry(original, maze);
+            if(symmetry >= 0) originals[m] = u;
+            last = u;
+        }
+
+        if(symmetry >= 0)
+        {
+            if(!summaryOnly) printDuplicate(m, originals[m], symmetry, !duplicates);
+            duplicates++;
+        }
+        else
+        {
+            if(last >= 0) index.next[last] = m;
+            else index.slots[slot] = m;
+            unique++;
+        }
+    }
+    if(!summaryOnly && format == JSON) printf("%s]\n", duplicates ? "\n" : "");
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    int status = 0;
+    if(outPath)
+    {
+        PackWriter writer;
+        if(beginPack(&writer, outPath, unique))
+        {
+            for(int m = 0; m < loaded; m++)
+            {
+                if(originals[m] >= 0 || !index.hashes[m]) continue;
+                Maze *maze = (Maze *) getMaze(m, &scratch);
+                const char *file = names ? names[m] : pack.entries[m].file[0] ? pack.entries[m].file : NULL;
+                if(!maze || !addToPack(&writer, maze, file)) break;
+            }
+            if(!finishPack(&writer)) status = -1;
+        }
+        else status = -1;
+    }
+
+    int removed = 0;
+    if(removeDuplicates)
+    {
+        char path[1024];
+        for(int m = 0; m < loaded; m++)
+        {
+            if(originals[m] < 0) continue;
+            snprintf(path, sizeof(path), "%s%s", mazeDirectory, names[m]);
+            if(unlink(path))
+            {
+                printf("Error: unable to delete %s\n", path);
+                status = -1;
+            }
+            else removed++;
+        }
+    }
+
+    if(format == TABLE || summaryOnly)
+    {
+        if(format == TABLE && !summaryOnly) printf("\n");
+        printf("Mazes: %d (%d could not be read)\n", loaded - failed, failed);
+        printf("Unique: %d\n", unique);
+        printf("Duplicates: %d\n", duplicates);
+        if(removeDuplicates) printf("Deleted: %d\n", removed);
+        if(outPath && !status) printf("Written: %d unique mazes to %s\n", unique, outPath);
+        printf("Elapsed: %.6f s\n", elapsed);
+        if(elapsed > 0) printf("Throughput: %.0f mazes/s\n", (loaded - failed) / elapsed);
+    }
+
+    freeMaze(&scratch);
+    freeMaze(&other);
+    if(packPath) closePack(&pack);
+    else
+    {
+        for(int m = 0; m < loaded; m++)
+        {
+            freeMaze(&mazes[m]);
+            free(names[m]);
+        }
+        free(names);
+        free(mazes);
+    }
+    free(index.slots);
+    free(index.hashes);
+    free(index.next);
+    free(originals);
+    return status;
+}
+
+// Returns the name a maze is reported under: its file name, or its name in the pack if it has none
+const char *getName(int m)
+{
+    return names ? names[m] : pack.entries[m].file[0] ? pack.entries[m].file : pack.entries[m].name;
+}
+
+// Returns maze m, decoding it into scratch when it comes from a pack
+// Returns NULL if the maze could not be decoded
+const Maze *getMaze(int m, Maze *scratch)
+{
+    if(!packPath) return &mazes[m];
+    return loadPackedMaze(&pack, m, scratch) ? scratch : NULL;
+}
+
+// Prints one duplicate as a table row, CSV line or JSON object
+void printDuplicate(int duplicate, int original, int symmetry, int first)
+{
+    if(format == TABLE) printf("%-24s %-24s %s\n", getName(duplicate), getName(original), symmetryNames[symmetry]);
+    else if(format == CSV) printf("%s,%s,%s\n", getName(duplicate), getName(original), symmetryNames[symmetry]);
+    else
+    {
+        printf("%s  {\"duplicate\": \"%s\", \"original\": \"%s\", \"symmetry\": \"%s\"}", first ? "" : ",\n",
+               getName(duplicate), getName(original), symmetryNames[symmetry]);
+    }
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--dir PATH [--remove] | --pack FILE] [--out FILE] [--summary] [--csv | --json]\n", program);
+    printf("  --dir PATH     folder of maze files to check (default ../Mazes/)\n");
+    printf("  --pack FILE    check the mazes in this pack file instead of a folder\n");
+    printf("  --remove       delete duplicate maze files from the folder\n");
+    printf("  --out FILE     write the unique mazes to this pack file\n");
+    printf("  --summary      only print totals\n");
+    printf("  --csv          print duplicates as CSV\n");
+    printf("  --json         print duplicates as JSON\n");
+}
@@ -0,0 +1,280 @@
+#include <stdlib.h>
+#include <string.h>
+#include "distance.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define DISTANCE_X86 1
+#endif
+
+// Distance fields are flooded out from the goal one wavefront at a time. Mazes up to 16x16 are held as sixteen
+// 16-bit rows in one AVX2 (or two SSE2) registers, so one wavefront step expands all frontier cells at once with
+// shifts masked by the open walls and never touches memory. A step costs the same however few cells it reaches,
+// and the long corridors of perfect and competition mazes make for many thin wavefronts, so every larger maze
+// uses a breadth-first search over the cells' wall masks, which was faster at every size from 17x17 up
+
+#ifdef DISTANCE_X86
+// Writes distance d for every set bit of a 64-bit chunk of a maze packed as sixteen 16-bit rows
+static inline void writePackedRows(int *distances, uint64_t bits, int firstRow, int size, int d)
+{
+    while(bits)
+    {
+        int bit = __builtin_ctzll(bits);
+        distances[(firstRow + (bit >> 4)) * size + (bit & 15)] = d;
+        bits &= bits - 1;
+    }
+}
+
+// Mazes up to 16x16 packed into 16-bit lanes, row y in lane y, held entirely in two SSE registers
+// Moving north/south shifts the whole maze by one lane, carrying the boundary lane between the registers
+__attribute__((target("sse2")))
+static int floodSmallSSE2(const uint16_t *openNorth, const uint16_t *openEast, const uint16_t *goals, int size, int *distances)
+{
+    __m128i northLo = _mm_loadu_si128((const __m128i *) openNorth);
+    __m128i northHi = _mm_loadu_si128((const __m128i *) (openNorth + 8));
+    __m128i eastLo = _mm_loadu_si128((const __m128i *) openEast);
+    __m128i eastHi = _mm_loadu_si128((const __m128i *) (openEast + 8));
+    __m128i frontLo = _mm_loadu_si128((const __m128i *) goals);
+    __m128i frontHi = _mm_loadu_si128((const __m128i *) (goals + 8));
+    __m128i visitedLo = frontLo, visitedHi = frontHi;
+    __m128i zero = _mm_setzero_si128();
+    int d = 0;
+
+    while(1)
+    {
+        // Cells that can move north, shifted up one row
+        __m128i upLo = _mm_and_si128(frontLo, northLo);
+        __m128i upHi = _mm_and_si128(frontHi, northHi);
+        __m128i north0 = _mm_slli_si128(upLo, 2);
+        __m128i north1 = _mm_or_si128(_mm_slli_si128(upHi, 2), _mm_srli_si128(upLo, 14));
+
+        // Cells shifted down one row, kept if the wall north of their new row is open
+        __m128i south0 = _mm_and_si128(_mm_or_si128(_mm_srli_si128(frontLo, 2), _mm_slli_si128(frontHi, 14)), northLo);
+        __m128i south1 = _mm_and_si128(_mm_srli_si128(frontHi, 2), northHi);
+
+        __m128i reached0 = _mm_or_si128(_mm_or_si128(north0, south0),
+                                        _mm_or_si128(_mm_slli_epi16(_mm_and_si128(frontLo, eastLo), 1), _mm_and_si128(_mm_srli_epi16(frontLo, 1), eastLo)));
+        __m128i reached1 = _mm_or_si128(_mm_or_si128(north1, south1),
+                                        _mm_or_si128(_mm_slli_epi16(_mm_and_si128(frontHi, eastHi), 1), _mm_and_si128(_mm_srli_epi16(frontHi, 1), eastHi)));
+        frontLo = _mm_andnot_si128(visitedLo, reached0);
+        frontHi = _mm_andnot_si128(visitedHi, reached1);
+        if(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(frontLo, frontHi), zero)) == 0xFFFF) break;
+
+        visitedLo = _mm_or_si128(visitedLo, frontLo);
+        visitedHi = _mm_or_si128(visitedHi, frontHi);
+        d++;
+
+        uint64_t words[4];
+        _mm_storeu_si128((__m128i *) words, frontLo);
+        _mm_storeu_si128((__m128i *) (words + 2), frontHi);
+        for(int i = 0; i < 4; i++) writePackedRows(distances, words[i], i * 4, size, d);
+    }
+
+    return d;
+}
+
+// Same as floodSmallSSE2 with the whole maze in a single AVX2 register
+__attribute__((target("avx2")))
+static int floodSmallAVX2(const uint16_t *openNorth, const uint16_t *openEast, const uint16_t *goals, int size, int *distances)
+{
+    __m256i north = _mm256_loadu_si256((const __m256i *) openNorth);
+    __m256i east = _mm256_loadu_si256((const __m256i *) openEast);
+    __m256i frontier = _mm256_loadu_si256((const __m256i *) goals);
+    __m256i visited = frontier;
+    int d = 0;
+
+    while(1)
+    {
+        // Shift lanes up (row y to y + 1) and down (row y + 1 to y) across the two 128-bit halves
+        __m256i up = _mm256_and_si256(frontier, north);
+        __m256i movedNorth = _mm256_alignr_epi8(up, _mm256_permute2x128_si256(up, up, 0x08), 14);
+        __m256i movedSouth = _mm256_and_si256(_mm256_alignr_epi8(_mm256_permute2x128_si256(frontier, frontier, 0x81), frontier, 2), north);
+        __m256i movedEast = _mm256_slli_epi16(_mm256_and_si256(frontier, east), 1);
+        __m256i movedWest = _mm256_and_si256(_mm256_srli_epi16(frontier, 1), east);
+
+        frontier = _mm256_andnot_si256(visited, _mm256_or_si256(_mm256_or_si256(movedNorth, movedSouth), _mm256_or_si256(movedEast, movedWest)));
+        if(_mm256_testz_si256(frontier, frontier)) break;
+
+        visited = _mm256_or_si256(visited, frontier);
+        d++;
+
+        writePackedRows(distances, (uint64_t) _mm256_extract_epi64(frontier, 0), 0, size, d);
+        writePackedRows(distances, (uint64_t) _mm256_extract_epi64(frontier, 1), 4, size, d);
+        writePackedRows(distances, (uint64_t) _mm256_extract_epi64(frontier, 2), 8, size, d);
+        writePackedRows(distances, (uint64_t) _mm256_extract_epi64(frontier, 3), 12, size, d);
+    }
+
+    return d;
+}
+
+// Register flood kernel for mazes up to 16x16
+typedef int (*FloodKernel)(const uint16_t *openNorth, const uint16_t *openEast, const uint16_t *goals, int size,
+                           int *distances);
+
+// Selects the widest register kernel supported by the CPU, NULL if there is none
+static FloodKernel getFloodKernel()
+{
+    static FloodKernel kernel = NULL;
+    static int checked = 0;
+    if(!checked)
+    {
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2")) kernel = floodSmallAVX2;
+        else if(__builtin_cpu_supports("sse2")) kernel = floodSmallSSE2;
+        checked = 1;
+    }
+    return kernel;
+}
+#endif
+
+// Returns the name of the SIMD instruction set used for mazes up to 16x16, or "scalar" if they use the
+// breadth-first search too
+const char *getDistanceKernelName()
+{
+#ifdef DISTANCE_X86
+    FloodKernel kernel = getFloodKernel();
+    if(kernel == floodSmallAVX2) return "avx2";
+    if(kernel == floodSmallSSE2) return "sse2";
+#endif
+    return "scalar";
+}
+
+#ifdef DISTANCE_X86
+// Mazes up to 16x16 (16-bit rows); runs entirely in SIMD registers
+// Returns the largest distance, or -1 if no register kernel is available
+static int computeDistancesSmall(const Maze *maze, int *distances)
+{
+    FloodKernel kernel = getFloodKernel();
+    if(!kernel) return -1;
+
+    int size = maze->size;
+    uint16_t rowMask = (1U << size) - 1;
+    uint16_t openNorth[16] = {0}, openEast[16] = {0}, goals[16] = {0};
+    int lo = (size - 1) / 2, hi = size / 2;
+    uint16_t goalRow = ((1U << (hi + 1)) - 1) & ~((1U << lo) - 1);
+
+    for(int y = 0; y < size; y++)
+    {
+        openNorth[y] = ~maze->northWalls[y] & rowMask;
+        openEast[y] = ~maze->eastWalls[y] & rowMask;
+        if(y >= lo && y <= hi)
+        {
+            goals[y] = goalRow;
+            for(int x = lo; x <= hi; x++) distances[y * size + x] = 0;
+        }
+    }
+    openNorth[size - 1] = 0;
+
+    return kernel(openNorth, openEast, goals, size, distances);
+}
+#endif
+
+// Breadth-first search over the cells' wall masks, continuing from the cells queue[0..tail), which are all at
+// distance d; cells that already have a distance are not visited again. The border walls keep every move inside
+// the maze, so no bounds checks are needed
+// Returns the largest distance found
+static int floodQueue(const Maze *maze, int *distances, int *queue, int tail, int d)
+{
+    int size = maze->size;
+    int offsets[4] = {size, 1, -size, -1};
+    int head = 0;
+    while(head < tail)
+    {
+        int cell = queue[head++];
+        int next = distances[cell] + 1;
+        int open = ~(maze->walls[cell >> 1] >> ((cell & 1) << 2)) & 0xF;
+        while(open)
+        {
+            int neighbor = cell + offsets[__builtin_ctz(open)];
+            open &= open - 1;
+            if(distances[neighbor] != DISTANCE_UNREACHABLE) continue;
+            distances[neighbor] = next;
+            queue[tail++] = neighbor;
+        }
+    }
+
+    // Cells leave the queue in order of distance, so the last one is the farthest
+    return tail ? distances[queue[tail - 1]] : d;
+}
+
+// Any maze size; the breadth-first search of floodQueue from the goal cells
+// Returns the largest distance, or -1 if memory could not be allocated
+static int computeDistancesQueue(const Maze *maze, int *distances)
+{
+    int size = maze->size;
+    int *queue = malloc(sizeof(int) * size * size);
+    if(!queue) return -1;
+
+    int lo = (size - 1) / 2, hi = size / 2, tail = 0;
+    for(int y = lo; y <= hi; y++)
+    {
+        for(int x = lo; x <= hi; x++)
+        {
+            distances[y * size + x] = 0;
+            queue[tail++] = y * size + x;
+        }
+    }
+    int farthest = floodQueue(maze, distances, queue, tail, 0);
+    free(queue);
+    return farthest;
+}
+
+// Computes every cell's distance (in cells) to the nearest goal cell given the walls in maze, which may be a
+// partially known maze; unreachable cells get DISTANCE_UNREACHABLE
+// Returns the largest distance found, or -1 if memory could not be allocated
+int computeDistances(const Maze *maze, int *distances)
+{
+    int cells = maze->size * maze->size;
+    for(int i = 0; i < cells; i++) distances[i] = DISTANCE_UNREACHABLE;
+
+#ifdef DISTANCE_X86
+    if(maze->size <= 16)
+    {
+        int farthest = computeDistancesSmall(maze, distances);
+        if(farthest >= 0) return farthest;
+    }
+#endif
+    return computeDistancesQueue(maze, distances);
+}
+
+// Reference implementation of computeDistances using a plain breadth-first search
+int computeDistancesBFS(const Maze *maze, int *distances)
+{
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {1, 0, -1, 0};
+    int size = maze->size;
+    int cells = size * size;
+    int *queue = malloc(sizeof(int) * cells);
+    if(!queue) return -1;
+
+    int head = 0, tail = 0, farthest = 0;
+    for(int i = 0; i < cells; i++)
+    {
+        distances[i] = DISTANCE_UNREACHABLE;
+        if(isGoal((Maze *) maze, i % size, i / size))
+        {
+            distances[i] = 0;
+            queue[tail++] = i;
+        }
+    }
+
+    while(head < tail)
+    {
+        int cell = queue[head++];
+        int x = cell % size, y = cell / size;
+        for(int d = 0; d < 4; d++)
+        {
+            if(hasWall(maze, x, y, d)) continue;
+            int next = cell + dy[d] * size + dx[d];
+            if(distances[next] == DISTANCE_UNREACHABLE)
+            {
+                distances[next] = distances[cell] + 1;
+                if(distances[next] > farthest) farthest = distances[next];
+                queue[tail++] = next;
+            }
+        }
+    }
+
+    free(queue);
+    return farthest;
+}
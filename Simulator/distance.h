@@ -0,0 +1,12 @@
+#ifndef DISTANCE_H
+#define DISTANCE_H
+
+#include "maze.h"
+
+#define DISTANCE_UNREACHABLE -1
+
+int computeDistances(const Maze *maze, int *distances);
+int computeDistancesBFS(const Maze *maze, int *distances);
+const char *getDistanceKernelName();
+
+#endif
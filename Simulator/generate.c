@@ -0,0 +1,422 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "generate.h"
+#include "mouse.h"
+
+// Access global variables from main.c
+extern int MAX_MAZE_SIZE, MIN_MAZE_SIZE;
+
+static const char *algorithmNames[GENERATE_ALGORITHMS] = {"dfs", "prim", "kruskal"};
+
+// Cell states used by the DFS and Prim generators
+enum {CELL_OPEN, CELL_VISITED, CELL_FRONTIER};
+
+// Returns the index of the named algorithm, or -1 if there is none
+int findAlgorithm(const char *name)
+{
+    for(int i = 0; i < GENERATE_ALGORITHMS; i++)
+    {
+        if(!strcmp(algorithmNames[i], name)) return i;
+    }
+
+    return -1;
+}
+
+const char *getAlgorithmName(GenerateAlgorithm algorithm)
+{
+    return algorithmNames[algorithm];
+}
+
+// Returns the seed of maze number index of a run started from seed: the index-th SplitMix64 output, so any
+// maze of a run can be regenerated on its own and runs with nearby seeds do not overlap
+uint64_t getMazeSeed(uint64_t seed, uint64_t index)
+{
+    uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// xorshift64* step
+static inline uint64_t nextRandom(MazeGenerator *generator)
+{
+    uint64_t x = generator->random;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    generator->random = x;
+    return x * 0x2545F4914F6CDD1DULL;
+}
+
+// Returns a random number in [0, bound)
+static inline int randomBelow(MazeGenerator *generator, int bound)
+{
+    return (int) (((nextRandom(generator) >> 32) * (uint64_t) bound) >> 32);
+}
+
+// Returns the index of the cell next to the given one in the given direction
+static inline int getNeighbor(int size, int cell, int direction)
+{
+    switch(direction)
+    {
+        case NORTH: return cell + size;
+        case EAST: return cell + 1;
+        case SOUTH: return cell - size;
+        default: return cell - 1;
+    }
+}
+
+// Removes the wall on the given side of a cell from both cells' wall masks; the row bitsets are derived at the end
+static inline void openWall(Maze *maze, int cell, int direction)
+{
+    int next = getNeighbor(maze->size, cell, direction);
+    maze->walls[cell >> 1] &= ~((1 << direction) << ((cell & 1) << 2));
+    maze->walls[next >> 1] &= ~((1 << ((direction + 2) & 3)) << ((next & 1) << 2));
+}
+
+// Rebuilds the row bitsets from the cell wall masks
+static void updateRowWalls(Maze *maze)
+{
+    int size = maze->size, rowWords = maze->rowWords;
+    for(int y = 0; y < size; y++)
+    {
+        uint64_t *north = &maze->northWalls[y * rowWords];
+        uint64_t *east = &maze->eastWalls[y * rowWords];
+        memset(north, 0, sizeof(uint64_t) * rowWords);
+        memset(east, 0, sizeof(uint64_t) * rowWords);
+        for(int x = 0; x < size; x++)
+        {
+            int mask = getWalls(maze, x, y);
+            north[x >> 6] |= (uint64_t) (mask & WALL_NORTH) << (x & 63);
+            east[x >> 6] |= (uint64_t) ((mask & WALL_EAST) >> 1) << (x & 63);
+        }
+    }
+}
+
+// Keeps generation from removing the wall on the given side of a cell
+static void fixWall(MazeGenerator *generator, int cell, int direction)
+{
+    int next = getNeighbor(generator->options.size, cell, direction);
+    generator->openable[cell] &= ~(1 << direction);
+    generator->openable[next] &= ~(1 << ((direction + 2) & 3));
+}
+
+// Prepares a generator for the given options, allocating scratch memory for the maze size
+// Returns 1 on success, 0 if the options are invalid or memory could not be allocated
+int initGenerator(MazeGenerator *generator, const GeneratorOptions *options)
+{
+    memset(generator, 0, sizeof(*generator));
+    int size = options->size;
+    if(size < MIN_MAZE_SIZE || size > MAX_MAZE_SIZE)
+    {
+        printf("Error: Maze size must be between %d and %d\n", MIN_MAZE_SIZE, MAX_MAZE_SIZE);
+        return 0;
+    }
+    if(options->algorithm < 0 || options->algorithm >= GENERATE_ALGORITHMS)
+    {
+        printf("Error: Unknown maze generation algorithm\n");
+        return 0;
+    }
+    if(!(options->loops >= 0 && options->loops <= 1))
+    {
+        printf("Error: Loop density must be between 0 and 1\n");
+        return 0;
+    }
+    if(options->competition && size < 3)
+    {
+        printf("Error: Competition mazes must be at least 3x3\n");
+        return 0;
+    }
+    generator->options = *options;
+
+    size_t cells = (size_t) size * size;
+    generator->cellStates = malloc(cells);
+    generator->cellList = malloc(cells * sizeof(int));
+    generator->wallList = malloc(2 * cells * sizeof(int));
+    generator->openable = malloc(cells);
+    if(!generator->cellStates || !generator->cellList || !generator->wallList || !generator->openable)
+    {
+        printf("Error: Unable to allocate memory for %dx%d maze generation\n", size, size);
+        freeGenerator(generator);
+        return 0;
+    }
+
+    // Every wall between two cells may be removed, apart from the border and the competition walls: the ones
+    // around the goal area and the start cell's east wall
+    for(int y = 0; y < size; y++)
+    {
+        for(int x = 0; x < size; x++)
+        {
+            int mask = 0;
+            if(y < size - 1) mask |= WALL_NORTH;
+            if(x < size - 1) mask |= WALL_EAST;
+            if(y > 0) mask |= WALL_SOUTH;
+            if(x > 0) mask |= WALL_WEST;
+            generator->openable[y * size + x] = mask;
+        }
+    }
+    if(options->competition)
+    {
+        int lo = (size - 1) / 2, hi = size / 2;
+        for(int i = lo; i <= hi; i++)
+        {
+            fixWall(generator, lo * size + i, SOUTH);
+            fixWall(generator, hi * size + i, NORTH);
+            fixWall(generator, i * size + lo, WEST);
+            fixWall(generator, i * size + hi, EAST);
+        }
+        fixWall(generator, 0, EAST);
+    }
+
+    return 1;
+}
+
+void freeGenerator(MazeGenerator *generator)
+{
+    free(generator->cellStates);
+    free(generator->cellList);
+    free(generator->wallList);
+    free(generator->openable);
+    memset(generator, 0, sizeof(*generator));
+}
+
+// Recursive backtracker: a random walk that backs up when it gets stuck. Long winding corridors, few branches
+static void generateDFS(MazeGenerator *generator, Maze *maze, int start)
+{
+    int size = maze->size;
+    const uint8_t *openable = generator->openable;
+    uint8_t *states = generator->cellStates;
+    int *stack = generator->cellList;
+    int top = 0;
+    states[start] = CELL_VISITED;
+    stack[top++] = start;
+
+    while(top)
+    {
+        int cell = stack[top - 1];
+        int choices[4], count = 0;
+        for(int d = 0; d < 4; d++)
+        {
+            if((openable[cell] >> d) & 1 && states[getNeighbor(size, cell, d)] == CELL_OPEN) choices[count++] = d;
+        }
+        if(!count)
+        {
+            top--;
+            continue;
+        }
+
+        int d = choices[count == 1 ? 0 : randomBelow(generator, count)];
+        int next = getNeighbor(size, cell, d);
+        openWall(maze, cell, d);
+        states[next] = CELL_VISITED;
+        stack[top++] = next;
+    }
+}
+
+// Adds the unvisited neighbors of a cell to the Prim frontier
+static void addFrontier(MazeGenerator *generator, int cell, int *count)
+{
+    int size = generator->options.size;
+    for(int d = 0; d < 4; d++)
+    {
+        if(!((generator->openable[cell] >> d) & 1)) continue;
+        int next = getNeighbor(size, cell, d);
+        if(generator->cellStates[next] != CELL_OPEN) continue;
+        generator->cellStates[next] = CELL_FRONTIER;
+        generator->cellList[(*count)++] = next;
+    }
+}
+
+// Randomized Prim: grows the maze from a random frontier cell each step. Short dead ends, many branches
+static void generatePrim(MazeGenerator *generator, Maze *maze, int start)
+{
+    int size = maze->size;
+    const uint8_t *openable = generator->openable;
+    uint8_t *states = generator->cellStates;
+    int *frontier = generator->cellList;
+    int count = 0;
+    states[start] = CELL_VISITED;
+    addFrontier(generator, start, &count);
+
+    while(count)
+    {
+        int i = randomBelow(generator, count);
+        int cell = frontier[i];
+        frontier[i] = frontier[--count];
+
+        // Connect the cell to a random neighbor that is already part of the maze
+        int choices[4], options = 0;
+        for(int d = 0; d < 4; d++)
+        {
+            if((openable[cell] >> d) & 1 && states[getNeighbor(size, cell, d)] == CELL_VISITED) choices[options++] = d;
+        }
+        openWall(maze, cell, choices[options == 1 ? 0 : randomBelow(generator, options)]);
+        states[cell] = CELL_VISITED;
+        addFrontier(generator, cell, &count);
+    }
+}
+
+// Union-find root with path halving
+static inline int findRoot(int *parents, int cell)
+{
+    while(parents[cell] != cell)
+    {
+        parents[cell] = parents[parents[cell]];
+        cell = parents[cell];
+    }
+
+    return cell;
+}
+
+// Randomized Kruskal: removes walls in random order whenever they separate unconnected regions. Unbiased
+// texture between the other two
+static void generateKruskal(MazeGenerator *generator, Maze *maze)
+{
+    int size = maze->size;
+    const uint8_t *openable = generator->openable;
+    int *parents = generator->cellList;
+    int *walls = generator->wallList;
+    int count = 0;
+
+    // Cells already joined (the goal area of competition mazes) start out in one set
+    for(int cell = 0; cell < size * size; cell++) parents[cell] = cell;
+    for(int cell = 0; cell < size * size; cell++)
+    {
+        int open = ~getWalls(maze, cell % size, cell / size) & openable[cell];
+        if(open & WALL_NORTH) parents[findRoot(parents, cell)] = findRoot(parents, cell + size);
+        if(open & WALL_EAST) parents[findRoot(parents, cell)] = findRoot(parents, cell + 1);
+        if(openable[cell] & WALL_NORTH) walls[count++] = cell * 2;
+        if(openable[cell] & WALL_EAST) walls[count++] = cell * 2 + 1;
+    }
+
+    // Visit the walls in random order (an incremental Fisher-Yates shuffle)
+    for(int i = 0; i < count; i++)
+    {
+        int j = i + randomBelow(generator, count - i);
+        int wall = walls[j];
+        walls[j] = walls[i];
+
+        int cell = wall >> 1, direction = (wall & 1) ? EAST : NORTH;
+        int a = findRoot(parents, cell);
+        int b = findRoot(parents, getNeighbor(size, cell, direction));
+        if(a == b) continue;
+        parents[a] = b;
+        openWall(maze, cell, direction);
+    }
+}
+
+// Returns the number of walls touching the post at the bottom left corner of cell (x, y); posts on the outer
+// border always touch the border
+static int countPostWalls(Maze *maze, int x, int y)
+{
+    if(x <= 0 || y <= 0 || x >= maze->size || y >= maze->size) return 4;
+    return hasWall(maze, x - 1, y - 1, NORTH) + hasWall(maze, x, y - 1, NORTH) + hasWall(maze, x - 1, y - 1, EAST) +
+           hasWall(maze, x - 1, y, EAST);
+}
+
+// Removes a share of the remaining interior walls to add loops. Under competition rules a wall is kept if
+// removing it would leave a post standing alone
+static void addLoops(MazeGenerator *generator, Maze *maze)
+{
+    int size = maze->size;
+    const uint8_t *openable = generator->openable;
+    int *walls = generator->wallList;
+    int count = 0;
+    for(int cell = 0; cell < size * size; cell++)
+    {
+        int closed = getWalls(maze, cell % size, cell / size) & openable[cell];
+        if(closed & WALL_NORTH) walls[count++] = cell * 2;
+        if(closed & WALL_EAST) walls[count++] = cell * 2 + 1;
+    }
+
+    int target = (int) (generator->options.loops * count + 0.5);
+    for(int i = 0, removed = 0; i < count && removed < target; i++)
+    {
+        int j = i + randomBelow(generator, count - i);
+        int wall = walls[j];
+        walls[j] = walls[i];
+
+        // A north wall runs between the posts at the cell's top corners, an east wall between the posts at its
+        // right corners
+        int cell = wall >> 1, x = cell % size, y = cell / size;
+        int direction = (wall & 1) ? EAST : NORTH;
+        if(generator->options.competition)
+        {
+            int ax = direction == NORTH ? x : x + 1, ay = direction == NORTH ? y + 1 : y;
+            if(countPostWalls(maze, ax, ay) < 2 || countPostWalls(maze, x + 1, y + 1) < 2) continue;
+        }
+        openWall(maze, cell, direction);
+        removed++;
+    }
+}
+
+// Generates a random maze from the given seed into maze, reusing its storage when it is already the right size
+// The same options and seed always give the same maze
+// Returns 1 on success, 0 if memory could not be allocated
+int generateMaze(MazeGenerator *generator, Maze *maze, uint64_t seed)
+{
+    const GeneratorOptions *options = &generator->options;
+    int size = options->size;
+#ifndef HEADLESS
+    maze->mazeTexture = NULL;
+#endif
+    if(maze->size != size && !clearMaze(maze, size)) return 0;
+    snprintf(maze->name, sizeof(maze->name), "%s%s %dx%d seed %016llx", getAlgorithmName(options->algorithm),
+             options->competition ? " competition" : "", size, size, (unsigned long long) seed);
+
+    // xorshift needs a nonzero state
+    generator->random = seed ? seed : 0x9E3779B97F4A7C15ULL;
+
+    // Start with every wall in place
+    size_t cells = (size_t) size * size;
+    memset(maze->walls, 0xFF, cells / 2);
+    if(cells & 1) maze->walls[cells / 2] = 0x0F;
+    memset(generator->cellStates, CELL_OPEN, cells);
+
+    // Competition mazes: open up the goal area, which is already walled in, generate the rest of the maze around
+    // it and then add one entrance
+    int lo = (size - 1) / 2, hi = size / 2;
+    if(options->competition)
+    {
+        for(int y = lo; y <= hi; y++)
+        {
+            for(int x = lo; x <= hi; x++)
+            {
+                if(x < hi) openWall(maze, y * size + x, EAST);
+                if(y < hi) openWall(maze, y * size + x, NORTH);
+                generator->cellStates[y * size + x] = CELL_VISITED;
+            }
+        }
+    }
+
+    switch(options->algorithm)
+    {
+        case GENERATE_DFS: generateDFS(generator, maze, 0); break;
+        case GENERATE_PRIM: generatePrim(generator, maze, 0); break;
+        default: generateKruskal(generator, maze); break;
+    }
+
+    if(options->competition)
+    {
+        // Pick the entrance among the goal area's walls, going around it counterclockwise from its bottom left
+        int side = hi - lo + 1;
+        int entrance = randomBelow(generator, 4 * side);
+        int offset = entrance % side;
+        switch(entrance / side)
+        {
+            case 0: openWall(maze, lo * size + lo + offset, SOUTH); break;
+            case 1: openWall(maze, (lo + offset) * size + hi, EAST); break;
+            case 2: openWall(maze, hi * size + hi - offset, NORTH); break;
+            default: openWall(maze, (hi - offset) * size + lo, WEST); break;
+        }
+    }
+
+    if(options->loops > 0) addLoops(generator, maze);
+    updateRowWalls(maze);
+
+    // Walls were carved directly, so the sensor rays are out of date; loading the maze back rebuilds them
+    maze->raysValid = 0;
+
+    return 1;
+}
@@ -0,0 +1,38 @@
+#ifndef GENERATE_H
+#define GENERATE_H
+
+#include <stdint.h>
+#include "maze.h"
+
+// Algorithms for the perfect maze (exactly one path between any two cells) that generation starts from
+typedef enum {GENERATE_DFS, GENERATE_PRIM, GENERATE_KRUSKAL, GENERATE_ALGORITHMS} GenerateAlgorithm;
+
+typedef struct
+{
+    int size;                       // Maze dimensions (cells)
+    GenerateAlgorithm algorithm;
+    double loops;                   // Fraction of the perfect maze's interior walls to remove again, 0 to 1
+    int competition;                // 1 to follow competition rules: the goal is walled in with a single entrance,
+                                    // the start cell is walled on the east and every post touches a wall
+} GeneratorOptions;
+
+// Generator settings plus scratch memory sized for the maze, so mazes can be generated back to back without
+// allocating. A maze depends only on the options and its seed
+typedef struct
+{
+    GeneratorOptions options;
+    uint64_t random;                // xorshift64* state
+    uint8_t *cellStates;            // Per-cell visited / frontier flags
+    int *cellList;                  // DFS stack, Prim frontier or Kruskal union-find parents
+    int *wallList;                  // Candidate walls as cell * 2 + (0 for north, 1 for east)
+    uint8_t *openable;              // Per-cell mask of the walls generation may remove (WALL_NORTH | ...)
+} MazeGenerator;
+
+int initGenerator(MazeGenerator *generator, const GeneratorOptions *options);
+void freeGenerator(MazeGenerator *generator);
+int generateMaze(MazeGenerator *generator, Maze *maze, uint64_t seed);
+uint64_t getMazeSeed(uint64_t seed, uint64_t index);
+int findAlgorithm(const char *name);
+const char *getAlgorithmName(GenerateAlgorithm algorithm);
+
+#endif
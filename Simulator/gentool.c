@@ -0,0 +1,233 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "maze.h"
+#include "pack.h"
+#include "generate.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazeDirectory = NULL;         // Folder to write maze text files to, NULL to not write text files
+char *packPath = NULL;              // Pack file to write the mazes to
+unsigned long long seed = 1;        // Seed of the run; maze i is generated from getMazeSeed(seed, i)
+long first = 0;                     // Index of the first maze to generate
+long count = 1;                     // Number of mazes to generate
+int threads = 0;                    // Number of worker threads, 0 to use one per core
+
+// Cells of the mazes a round holds between generating them and writing them out in order
+#define ROUND_CELLS (1 << 20)
+
+// Mazes first to first + count - 1, generated by the workers in any order and then written and checksummed in
+// order by the main thread
+typedef struct
+{
+    Maze *mazes;            // Maze first + k in mazes[k]
+    uint64_t *hashes;       // Record hash of each maze
+    char *done;             // 1 for each maze that was generated
+    long first;
+    long count;
+    atomic_long next;
+} GenerateRound;
+
+// Each worker keeps its own generator scratch memory across rounds
+typedef struct
+{
+    GenerateRound *round;
+    MazeGenerator generator;
+    uint8_t *record;
+} GenerateWorker;
+
+void generateRound(GenerateWorker *workers, int threads);
+void printUsage(const char *program);
+
+// MAIN
+// Generates reproducible random mazes into memory, a pack file or a folder of maze text files
+int main(int argc, char** argv)
+{
+    GeneratorOptions options = {16, GENERATE_DFS, 0, 0};
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--size") && i + 1 < argc) options.size = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--loops") && i + 1 < argc) options.loops = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--competition")) options.competition = 1;
+        else if(!strcmp(argv[i], "--seed") && i + 1 < argc) seed = strtoull(argv[++i], NULL, 0);
+        else if(!strcmp(argv[i], "--first") && i + 1 < argc) first = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--count") && i + 1 < argc) count = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--dir") && i + 1 < argc) mazeDirectory = argv[++i];
+        else if(!strcmp(argv[i], "--pack") && i + 1 < argc) packPath = argv[++i];
+        else if(!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--algorithm") && i + 1 < argc)
+        {
+            int algorithm = findAlgorithm(argv[++i]);
+            if(algorithm < 0)
+            {
+                printf("Error: unknown algorithm %s\n", argv[i]);
+                return -1;
+            }
+            options.algorithm = algorithm;
+        }
+        else
+        {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+
+    if(count < 1 || first < 0 || (packPath && count > 0x7FFFFFFF))
+    {
+        printf("Error: maze count must be positive (and fit in a pack) and the first index must not be negative\n");
+        return -1;
+    }
+    if(threads < 0)
+    {
+        printf("Error: thread count must not be negative\n");
+        return -1;
+    }
+    if(threads == 0)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? cores : 1;
+    }
+
+    // A round holds about ROUND_CELLS cells of mazes, and at least one maze per thread
+    long roundSize = ROUND_CELLS / ((long) options.size * options.size);
+    if(roundSize < threads) roundSize = threads;
+    if(roundSize > count) roundSize = count;
+    if(threads > roundSize) threads = roundSize;
+
+    GenerateRound round = {calloc(roundSize, sizeof(Maze)), malloc(sizeof(uint64_t) * roundSize), malloc(roundSize)};
+    GenerateWorker *workers = calloc(threads, sizeof(GenerateWorker));
+    if(!round.mazes || !round.hashes || !round.done || !workers)
+    {
+        printf("Error: unable to allocate %ld mazes\n", roundSize);
+        return -1;
+    }
+    for(int t = 0; t < threads; t++)
+    {
+        workers[t].round = &round;
+        workers[t].record = malloc(getRecordSize(options.size));
+        if(!workers[t].record || !initGenerator(&workers[t].generator, &options)) return -1;
+    }
+
+    // Maze paths are appended to the folder path, so make sure it ends with a separator
+    size_t length = mazeDirectory ? strlen(mazeDirectory) : 0;
+    if(length && mazeDirectory[length - 1] != '/')
+    {
+        char *directory = malloc(length + 2);
+        sprintf(directory, "%s/", mazeDirectory);
+        mazeDirectory = directory;
+    }
+
+    PackWriter writer;
+    if(packPath && !beginPack(&writer, packPath, count)) return -1;
+
+    // The checksum covers every maze generated, in order, so identical options and seeds must give identical
+    // checksums whatever the number of threads
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    unsigned long long checksum = 14695981039346656037ULL;
+    long generated = 0;
+    for(long r = first; r < first + count && generated == r - first; r += roundSize)
+    {
+        round.first = r;
+        round.count = first + count - r < roundSize ? first + count - r : roundSize;
+        generateRound(workers, threads);
+
+        for(long k = 0; k < round.count && round.done[k]; k++)
+        {
+            char fileName[32];
+            snprintf(fileName, sizeof(fileName), "gen_%07ld.txt", r + k);
+            if(packPath && !addToPack(&writer, &round.mazes[k], fileName)) break;
+            if(mazeDirectory && !saveMaze(&round.mazes[k], fileName)) break;
+
+            checksum = (checksum ^ round.hashes[k]) * 1099511628211ULL;
+            generated++;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+
+    int result = generated == count;
+    if(packPath) result &= finishPack(&writer);
+
+    printf("Generated:   %ld %s%s %dx%d mazes from seed %llu\n", generated, getAlgorithmName(options.algorithm),
+           options.competition ? " competition" : "", options.size, options.size, seed);
+    printf("Elapsed:     %.3f s\n", elapsed);
+    printf("Threads:     %d\n", threads);
+    printf("Throughput:  %.0f mazes/s\n", elapsed > 0 ? generated / elapsed : 0);
+    printf("Checksum:    %016llx\n", checksum);
+
+    for(int t = 0; t < threads; t++)
+    {
+        free(workers[t].record);
+        freeGenerator(&workers[t].generator);
+    }
+    for(long k = 0; k < roundSize; k++) freeMaze(&round.mazes[k]);
+    free(workers);
+    free(round.mazes);
+    free(round.hashes);
+    free(round.done);
+    return result ? 0 : -1;
+}
+
+// Worker thread: claims mazes of the round one at a time until none are left, generating each one and hashing
+// its record for the checksum
+static void *generateWorker(void *arg)
+{
+    GenerateWorker *worker = arg;
+    GenerateRound *round = worker->round;
+    size_t recordSize = getRecordSize(worker->generator.options.size);
+
+    while(1)
+    {
+        long k = atomic_fetch_add(&round->next, 1);
+        if(k >= round->count) break;
+
+        Maze *maze = &round->mazes[k];
+        round->done[k] = generateMaze(&worker->generator, maze, getMazeSeed(seed, round->first + k));
+        if(!round->done[k]) continue;
+        encodeRecord(maze, worker->record);
+        round->hashes[k] = hashRecord(worker->record, recordSize);
+    }
+
+    return NULL;
+}
+
+// Generates every maze of the round on the given number of threads, the calling thread being one of them
+void generateRound(GenerateWorker *workers, int threads)
+{
+    atomic_store(&workers[0].round->next, 0);
+
+    pthread_t *started = malloc(sizeof(pthread_t) * threads);
+    int running = 0;
+    for(int t = 1; started && t < threads; t++)
+    {
+        if(pthread_create(&started[running], NULL, generateWorker, &workers[t])) break;
+        running++;
+    }
+
+    generateWorker(&workers[0]);
+    for(int t = 0; t < running; t++) pthread_join(started[t], NULL);
+    free(started);
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--size N] [--algorithm dfs|prim|kruskal] [--loops FRACTION] [--competition] [--seed S] "
+           "[--first N] [--count N] [--threads N] [--pack FILE] [--dir PATH]\n", program);
+    printf("  --size N          maze dimensions (default 16)\n");
+    printf("  --algorithm NAME  perfect maze algorithm (default dfs)\n");
+    printf("  --loops FRACTION  share of interior walls to remove again to add loops, 0 to 1 (default 0)\n");
+    printf("  --competition     walled goal with one entrance, start walled on the east, no lone posts\n");
+    printf("  --seed S          seed of the run (default 1)\n");
+    printf("  --first N         index of the first maze, to regenerate part of a run (default 0)\n");
+    printf("  --count N         number of mazes (default 1)\n");
+    printf("  --threads N       worker threads (default: one per core)\n");
+    printf("  --pack FILE       write the mazes to a pack file\n");
+    printf("  --dir PATH        write the mazes as text files gen_NNNNNNN.txt to a folder\n");
+}
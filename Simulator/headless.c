@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "maze.h"
+#include "mouse.h"
+#include "solver.h"
+#include "simulate.h"
+#include "distance.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazePath = "default.txt";     // Name of default maze file used if no maze path provided
+char *mazeDirectory = "../Mazes/";  // Path to maze folder
+long maxSteps = 1000000;            // Maximum number of solver decisions per run
+long repeat = 1;                    // Number of times to run the simulation
+int checkDistances = 0;             // 1 to verify and time the distance kernel instead of simulating
+int solverIndex = 0;                // Index of the solver to run in the solvers table
+int timed = 0;                      // 1 to time runs with the motion model
+MotionProfile motionProfile;        // Motion profile runs are timed with
+char *tracePath = NULL;             // File to record the last run's decisions to, NULL to not record them
+long memoryBudget = 0;              // Memory the solver may allocate in a run (bytes), 0 for no limit
+
+// Global structs/objects
+Maze maze;
+SimContext context;
+
+void printUsage(const char *program);
+int runDistanceCheck();
+double timeDistances(int (*compute)(const Maze *, int *), int *distances);
+
+// MAIN
+// Runs the solver on a maze without opening a window and prints the results
+int main(int argc, char** argv)
+{
+    // Parse arguments
+    motionProfile = defaultMotionProfile;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--steps") && i + 1 < argc) maxSteps = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--repeat") && i + 1 < argc) repeat = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--solver") && i + 1 < argc)
+        {
+            solverIndex = findOrLoadSolver(argv[++i]);
+            if(solverIndex < 0)
+            {
+                printf("Error: unknown solver %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "--check-distances")) checkDistances = 1;
+        else if(!strcmp(argv[i], "--trace") && i + 1 < argc) tracePath = argv[++i];
+        else if(!strcmp(argv[i], "--memory") && i + 1 < argc)
+        {
+            memoryBudget = parseMemorySize(argv[++i]);
+            if(memoryBudget < 0)
+            {
+                printf("Error: invalid memory budget %s\n", argv[i]);
+                return -1;
+            }
+        }
+        else if(!strcmp(argv[i], "--motion") && i + 1 < argc)
+        {
+            timed = 1;
+            i++;
+            if(strcmp(argv[i], "default") && !parseMotionProfile(argv[i], &motionProfile)) return -1;
+        }
+        else if(!strcmp(argv[i], "--help"))
+        {
+            printUsage(argv[0]);
+            return 0;
+        }
+        else if(argv[i][0] == '-')
+        {
+            printUsage(argv[0]);
+            return -1;
+        }
+        else mazePath = argv[i];
+    }
+
+    if(maxSteps < 1 || repeat < 1)
+    {
+        printf("Error: step limit and repeat count must be positive\n");
+        return -1;
+    }
+
+    // Initialize maze
+    if(!loadMaze(&maze, mazePath))
+    {
+        printf("Error initializing maze, exiting\n");
+        return -1;
+    }
+
+    if(checkDistances) return runDistanceCheck();
+
+    // Run the simulation the requested number of times, starting fresh each time
+    SimStats stats;
+    long totalSteps = 0;
+    double totalTime = 0;
+    StartConfig start = {0, 0, NORTH};
+    Mouse *mouse = &context.mouse;
+    TraceWriter trace = {0};
+    initContext(&context, &maze, solverIndex);
+    setSolverBudget(&context.state, memoryBudget);
+    if(timed) enableMotion(&context, &motionProfile);
+    if(tracePath && !initTraceWriter(&trace, 1 << 20)) return -1;
+    for(long r = 0; r < repeat; r++)
+    {
+        startRun(&context, start);
+        if(tracePath && r == repeat - 1)
+        {
+            if(!beginTrace(&trace, tracePath, &maze, solvers[solverIndex].name)) return -1;
+            mouse->trace = &trace;
+        }
+        simulate(mouse, maxSteps, &stats);
+        totalSteps += stats.steps;
+        totalTime += stats.elapsed;
+    }
+
+    // Print results of the last run and overall throughput
+    if(stats.reachedGoal) printf("Result: reached goal\n");
+    else if(stats.overBudget) printf("Result: solver ran out of memory (budget %ld bytes)\n", memoryBudget);
+    else if(stats.crashed) printf("Result: mouse attempted to move through wall at (%d, %d)\n", mouse->x, mouse->y);
+    else if(stats.steps >= maxSteps) printf("Result: step limit reached\n");
+    else printf("Result: solver idled at (%d, %d)\n", mouse->x, mouse->y);
+
+    printf("Steps: %ld\n", stats.steps);
+    printf("Moves: %ld\n", stats.moves);
+    printf("Turns: %ld\n", stats.turns);
+    if(timed) printf("Run time: %.3f s (simulated)\n", stats.runTime);
+    printf("Solver memory: %ld bytes in %ld allocations", stats.memoryUsed, stats.allocations);
+    if(memoryBudget) printf(" (budget %ld bytes%s)", memoryBudget, stats.overBudget ? ", exceeded" : "");
+    printf("\n");
+    if(solvers[solverIndex].solve == floodFill)
+    {
+        unsigned long updates = context.state.floodFillUpdates;
+        printf("Flood fill updates: %lu (%.2f per decision; a full re-flood touches %d cells per decision)\n",
+               updates, stats.steps ? (double) updates / stats.steps : 0.0, maze.size * maze.size);
+    }
+    printf("Runs: %ld\n", repeat);
+    printf("Elapsed: %.6f s\n", totalTime);
+    if(totalTime > 0) printf("Throughput: %.0f decisions/s\n", totalSteps / totalTime);
+
+    if(tracePath && !flushTraces(&trace)) return -1;
+    freeTraceWriter(&trace);
+    freeContext(&context);
+    return stats.reachedGoal ? 0 : 1;
+}
+
+// Compares computeDistances against the reference breadth-first search on the loaded maze and on an empty maze
+// of the same size (what a solver knows before exploring), then times both
+// Returns 0 if all distances match
+int runDistanceCheck()
+{
+    int cells = maze.size * maze.size;
+    int *fast = malloc(sizeof(int) * cells);
+    int *reference = malloc(sizeof(int) * cells);
+    Maze empty = {0};
+    if(!fast || !reference || !clearMaze(&empty, maze.size)) return -1;
+
+    int mismatches = 0;
+    Maze *cases[2] = {&maze, &empty};
+    for(int c = 0; c < 2; c++)
+    {
+        int farthest = computeDistances(cases[c], fast);
+        if(farthest != computeDistancesBFS(cases[c], reference)) mismatches++;
+        for(int i = 0; i < cells; i++) if(fast[i] != reference[i]) mismatches++;
+    }
+
+    printf("Distance kernel: %s\n", maze.size <= 16 ? getDistanceKernelName() : "queue");
+    printf("Mismatches against BFS: %d\n", mismatches);
+    printf("Time per distance field: %.1f ns\n", timeDistances(computeDistances, fast));
+    printf("Time per distance field (reference BFS): %.1f ns\n", timeDistances(computeDistancesBFS, fast));
+
+    free(fast);
+    free(reference);
+    freeMaze(&empty);
+    return mismatches ? 1 : 0;
+}
+
+// Returns the time one call of compute takes on the loaded maze (nanoseconds), timing enough calls to get a
+// stable figure and doubling the batch so timer reads don't dominate
+double timeDistances(int (*compute)(const Maze *, int *), int *distances)
+{
+    long calls = 0, batch = 1;
+    double start = getTime(), elapsed = 0;
+    while(elapsed < 0.2)
+    {
+        for(long i = 0; i < batch; i++) compute(&maze, distances);
+        calls += batch;
+        batch *= 2;
+        elapsed = getTime() - start;
+    }
+    return elapsed / calls * 1e9;
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--solver NAME] [--steps N] [--repeat N] [--motion SETTINGS] [--memory BYTES] [--trace FILE]\n"
+           "       [--check-distances] [maze file]\n", program);
+    printf("  --solver NAME  maze solving algorithm to run:");
+    for(int i = 0; i < solverCount; i++) printf(" %s", solvers[i].name);
+    printf(",\n                 or the path to a solver plugin (.so)\n");
+    printf("  --steps N      stop each run after N solver decisions (default 1000000)\n");
+    printf("  --repeat N     run the simulation N times and report total throughput\n");
+    printf("  --motion SETTINGS  time runs with the motion model: default, or settings such as speed=2,accel=5,decel=5\n");
+    printf("                 (also cell, turnrate, turnaccel and step; see motion.c)\n");
+    printf("  --memory BYTES cap the memory the solver may allocate in a run, e.g. 2K or 8KB (default: no limit)\n");
+    printf("  --trace FILE   record the last run's decisions to a trace file (see tracetool)\n");
+    printf("  --check-distances  verify the distance kernel against BFS and time it\n");
+}
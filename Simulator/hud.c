@@ -0,0 +1,100 @@
+#include <SDL2/SDL.h>
+#include <stdio.h>
+#include <string.h>
+#include "hud.h"
+#include "timing.h"
+
+#define GLYPH_WIDTH 3               // Font glyph size (font pixels)
+#define GLYPH_HEIGHT 5
+#define HUD_LINES 4
+
+extern SDL_Renderer* renderer;
+extern SDL_Color BACKGROUND_COLOR, WALL_COLOR;
+
+int HUD_SCALE = 2;                  // Size of one font pixel (screen pixels)
+int HUD_REFRESH_INTERVAL = 250;     // Time between updates of the figures shown (milliseconds)
+
+// 3x5 pixel font for characters ' ' to 'Z': each glyph is five 3-bit rows, top row in the highest bits
+static const unsigned short glyphs[] = {
+    0, 0, 0, 0, 0, 0x52A5, 0, 0, 0x2922, 0x224A,
+    0, 0, 0, 0x01C0, 0x0002, 0x12A4, 0x7B6F, 0x2C97, 0x73E7, 0x73CF,
+    0x5BC9, 0x79CF, 0x79EF, 0x7252, 0x7BEF, 0x7BCF, 0x0410, 0, 0, 0,
+    0, 0, 0, 0x2BED, 0x6BAE, 0x3923, 0x6B6E, 0x79A7, 0x79A4, 0x396B,
+    0x5BED, 0x7497, 0x126A, 0x5BAD, 0x4927, 0x5FED, 0x6B6D, 0x2B6A, 0x6BA4, 0x2B73,
+    0x6BAD, 0x388E, 0x7492, 0x5B6F, 0x5B6A, 0x5BFD, 0x5AAD, 0x5A92, 0x72A7,
+};
+
+static char hudLines[HUD_LINES][80];
+static Uint32 lastRefresh = 0;
+
+// Draws a line of text in the wall color with the built-in pixel font, scaled by scale; lower case letters are
+// drawn as capitals and characters the font lacks as spaces
+// Returns the width of the text (pixels)
+int renderText(int x, int y, int scale, const char *text)
+{
+    // Every lit font pixel of the line is drawn in one batch
+    SDL_Rect pixels[80 * GLYPH_WIDTH * GLYPH_HEIGHT];
+    int count = 0, length = 0;
+    for(; text[length] && length < 80; length++)
+    {
+        int c = text[length];
+        if(c >= 'a' && c <= 'z') c -= 'a' - 'A';
+        unsigned short glyph = (c >= ' ' && c <= 'Z') ? glyphs[c - ' '] : 0;
+        for(int bit = 0; bit < GLYPH_WIDTH * GLYPH_HEIGHT; bit++)
+        {
+            if(!(glyph >> (GLYPH_WIDTH * GLYPH_HEIGHT - 1 - bit) & 1)) continue;
+            int column = bit % GLYPH_WIDTH, row = bit / GLYPH_WIDTH;
+            int left = x + (length * (GLYPH_WIDTH + 1) + column) * scale;
+            pixels[count++] = (SDL_Rect) {left, y + row * scale, scale, scale};
+        }
+    }
+
+    SDL_SetRenderDrawColor(renderer, WALL_COLOR.r, WALL_COLOR.g, WALL_COLOR.b, 0xFF);
+    if(count) SDL_RenderFillRects(renderer, pixels, count);
+    return length * (GLYPH_WIDTH + 1) * scale;
+}
+
+// Updates the figures shown in the overlay from the rolling timing statistics
+static void refreshHud()
+{
+    TimingSummary frame, solver, maze, mouse, present;
+    summarizeTiming(STAGE_FRAME, &frame);
+    summarizeTiming(STAGE_SOLVER, &solver);
+    summarizeTiming(STAGE_MAZE, &maze);
+    summarizeTiming(STAGE_MOUSE, &mouse);
+    summarizeTiming(STAGE_PRESENT, &present);
+
+    snprintf(hudLines[0], sizeof(hudLines[0]), "FPS %.1f  FRAME %.2f MS (MIN %.2f P99 %.2f)",
+             frame.count ? 1e6 / frame.mean : 0.0, frame.mean * 1e-3, frame.min * 1e-3, frame.p99 * 1e-3);
+    snprintf(hudLines[1], sizeof(hudLines[1]), "SOLVER %.2f US/DECISION (P99 %.2f)", solver.mean, solver.p99);
+    snprintf(hudLines[2], sizeof(hudLines[2]), "MAZE %.0f  MOUSE %.0f  PRESENT %.0f US (P99 %.0f)", maze.mean,
+             mouse.mean, present.mean, present.p99);
+    snprintf(hudLines[3], sizeof(hudLines[3]), "%s", isTimingTraceOpen() ? "RECORDING TIMING TRACE" : "");
+}
+
+// Draws the timing overlay with its top left corner at (x, y), refreshing its figures a few times a second so
+// they stay readable
+// Returns the screen area drawn over
+SDL_Rect renderHud(int x, int y)
+{
+    if(SDL_GetTicks() - lastRefresh >= (Uint32) HUD_REFRESH_INTERVAL || !lastRefresh)
+    {
+        lastRefresh = SDL_GetTicks();
+        refreshHud();
+    }
+
+    // Clear a box behind the text so it stays legible over the maze
+    int lineHeight = (GLYPH_HEIGHT + 2) * HUD_SCALE;
+    int width = 0;
+    for(int i = 0; i < HUD_LINES; i++)
+    {
+        int length = strlen(hudLines[i]) * (GLYPH_WIDTH + 1) * HUD_SCALE;
+        if(length > width) width = length;
+    }
+    SDL_Rect box = {x, y, width + 2 * HUD_SCALE, HUD_LINES * lineHeight + HUD_SCALE};
+    SDL_SetRenderDrawColor(renderer, BACKGROUND_COLOR.r, BACKGROUND_COLOR.g, BACKGROUND_COLOR.b, 0xFF);
+    SDL_RenderFillRect(renderer, &box);
+
+    for(int i = 0; i < HUD_LINES; i++) renderText(x + HUD_SCALE, y + HUD_SCALE + i * lineHeight, HUD_SCALE, hudLines[i]);
+    return box;
+}
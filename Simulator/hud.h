@@ -0,0 +1,9 @@
+#ifndef HUD_H
+#define HUD_H
+
+#include <SDL2/SDL.h>
+
+int renderText(int x, int y, int scale, const char *text);
+SDL_Rect renderHud(int x, int y);
+
+#endif
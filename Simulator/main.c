@@ -1,9 +1,18 @@
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "maze.h"
 #include "mouse.h"
+#include "solver.h"
+#include "motion.h"
+#include "trace.h"
+#include "timing.h"
+#include "hud.h"
+
+#define MAX_DIRTY_RECTS 16          // Screen areas to restore per frame before falling back to a full repaint
 
 // Global variables
 // NOTE: not all constant; some of these get updated if window is resized
@@ -12,14 +21,18 @@ const int INIT_HEIGHT = 480;        // Initial screen height (pixels)
 int SCREEN_WIDTH = INIT_WIDTH;      // Screen width (pixels)
 int SCREEN_HEIGHT = INIT_HEIGHT;    // Screen height (pixels)
 int MAZE_PADDING = 50;              // Padding between maze border and edge of screen (pixels)
-int WALL_THICKNESS = 5;             // Thickness of maze wall (pixels)
-int MAX_MAZE_SIZE = 16;             // Maximum maze dimensions (cells)
+int MAX_WALL_THICKNESS = 5;         // Thickness of maze wall when cells are large enough (pixels)
+int WALL_THICKNESS = 5;             // Thickness of maze wall, shrunk for large mazes (pixels)
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
 int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
 float MOUSE_SIZE = 0.75;            // Size of mouse (percentage of cell size)
-int MOVE_STEP = 2;                  // Distance to move in single frame (pixels)
-int TURN_STEP = 3;                  // Amount to turn in single frame (degrees)
-float xCorrection = 1;              // Scaling factor for when screen is resized
-float yCorrection = 1;              // Scaling factor for when screen is resized
+int TICK_LENGTH = 5;                // Length of one simulation tick, the motion model's time step (milliseconds)
+int MAX_FRAME_TIME = 250;           // Longest frame simulated in full; time beyond this is dropped (milliseconds)
+int FRAME_TIME = 16;                // Minimum time between frames when the renderer has no vsync (milliseconds)
+float SPEEDS[] = {0.1, 0.25, 0.5, 1, 2, 5, 10, 25, 50, 100, 250, 500, 1000};  // Simulation speed multipliers
+int speedIndex = 3;                 // Index of the current simulation speed in SPEEDS
+double pendingTicks = 0;            // Simulation time that has passed but not been simulated yet (ticks)
+int vsync = 0;                      // 1 if presenting waits for the display refresh
 int MAZE_WIDTH;                     // Width of maze border wall (pixels)
 int CELL_LENGTH;                    // Length of one cell (pixels)
 int x_0, y_0;                       // Position of upper left maze corner (pixels)
@@ -28,6 +41,12 @@ int MAX_SCREEN_DIMENSION;           // Store the larger screen dimension out of
 char *mazePath = "default.txt";     // Name of default maze file used if no maze path provided
 char *mazeDirectory = "../Mazes/";  // Path to maze folder
 int running = 0;                    // 1 if actively running simulation, 0 otherwise
+int finishPaused = 0;               // 1 once the race has paused for being finished, so resuming keeps it running
+int MAX_MICE = 1024;                // Most mice that can race on the maze at once
+int PLUGIN_CHECK_INTERVAL = 500;    // Time between checks for a rebuilt solver plugin (milliseconds)
+int SEEK_STEPS = 100;               // Steps skipped by Page Up/Page Down when replaying a trace
+int hudVisible = 0;                 // 1 to draw the timing overlay
+char *timingTracePath = "timing.json";  // File the timing trace is written to
 
 // Wall and background colors
 SDL_Color BACKGROUND_COLOR = {255,255,255};
@@ -38,47 +57,117 @@ SDL_Window* window = NULL;
 SDL_Renderer* renderer = NULL;
 SDL_Event e;
 Maze maze;
-Mouse mouse;
+Mouse *mice = NULL;                 // Mice racing on the maze, all advanced by the same simulation ticks
+SolverState *solverStates = NULL;   // Solver state of each mouse
+MotionState *motions = NULL;        // Body of each mouse
+int *goalReported = NULL;           // 1 for each mouse whose time to the goal has been printed
+int mouseCount = 0;
+TraceReader replay;                 // Trace being replayed, if a trace file was given instead of a solver
+uint64_t replayStep = 0;            // Step of the trace the replay solver reads next
+
+// Frames are drawn into frameTexture, which keeps the screen between frames, so only the areas drawn over in the
+// last frame (listed in dirtyRects) have to be restored from the maze texture instead of redrawing everything
+SDL_Texture* frameTexture = NULL;
+SDL_Rect dirtyRects[MAX_DIRTY_RECTS];
+int dirtyCount = 0;
+int fullRepaint = 1;                // 1 if the whole frame has to be redrawn, e.g. after a resize or theme change
 
 // Function prototypes
 int init();
 int resizeWindow(int width, int height);
 int quit();
+void updateCellLength();
 void renderScreen();
+void createFrameTexture();
+void updateMazeTexture();
+void markDirty(SDL_Rect rect);
+int addMice(const char *spec);
+int spreadSettings(const char *settings, int index, int count, char *out, size_t size);
+SDL_Color getMouseColor(int index);
+int stepMice();
+void restartMice();
+Action replaySolver(Mouse *mouse);
+void seekReplay(long long step);
 
 // MAIN
-// Can take in one parameter that is the path to a maze file
+// Can take in the path to a maze file followed by the solvers to race on it, each given by name or as the path
+// to a solver plugin (which is reloaded whenever it is rebuilt); a .trace file can be given instead to replay it
+// Each solver may be prefixed with a number of mice and followed by motion settings, e.g. 10*floodFill:speed=1..3
 int main(int argc, char** argv)
 {
     // Initialize application
     if(!init()) return -1;
 
-    // Initialize maze
-    if (argc == 2) mazePath = argv[1];
+    // Initialize maze and solvers
+    size_t length = argc >= 3 ? strlen(argv[2]) : 0;
+    if (argc >= 2) mazePath = argv[1];
+    if (length > 6 && !strcmp(argv[2] + length - 6, ".trace"))
+    {
+        if(argc > 3)
+        {
+            printf("Error: a trace can only be replayed on its own\n");
+            return quit() - 1;
+        }
+        if(!openTrace(&replay, argv[2])) return quit() - 1;
+        registerSolver("replay", replaySolver, NULL);
+        if(!addMice("replay")) return quit() - 1;
+    }
+    else if(argc < 3 && !addMice(solvers[0].name)) return quit() - 1;
+    for(int i = 2; i < argc && !replay.data; i++)
+    {
+        if(!addMice(argv[i])) return quit() - 1;
+    }
     if(!loadMaze(&maze, mazePath))
     {
         printf("Error initializing maze, exiting\n");
         return quit() - 1;
     }
 
-    CELL_LENGTH = MAZE_WIDTH / maze.size;
-    maze.mazeTexture = createMazeTexture(&maze);
+    updateCellLength();
+    updateMazeTexture();
+    createFrameTexture();
 
-    // Initialize mouse
-    if(!loadMouse(&mouse))
+    // Initialize mice; their arrays are complete, so the pointers between them stay valid
+    for(int i = 0; i < mouseCount; i++)
     {
-        printf("Error initializing mouse, exiting\n");
-        return quit() - 1;
+        mice[i].motion = &motions[i];
+        mice[i].state = &solverStates[i];
+        if(!loadMouse(&mice[i], &maze))
+        {
+            printf("Error initializing mouse, exiting\n");
+            return quit() - 1;
+        }
     }
+    if(mouseCount > 1) printf("Racing %d mice\n", mouseCount);
 
-    printf("Press s to start simulation\n");
+    printf("Press s to start simulation, n to single-step and +/- to change speed\n");
+    printf("Press h to show timings and t to start or stop recording a timing trace\n");
+    if(replay.data)
+    {
+        if(replay.header->mazeSize != maze.size) printf("Warning: trace was recorded on a maze of a different size\n");
+        printf("Replaying %s on %s (%llu steps); use the arrow keys, Page Up/Page Down and Home/End to seek\n",
+               replay.header->solverName, replay.header->mazeName, (unsigned long long) replay.steps);
+        seekReplay(0);
+    }
 
     // Render initial screen
     renderScreen();
 
     // Program loop
+    int pluginLoaded = 0;
+    for(int i = 0; i < mouseCount; i++)
+    {
+        if(solvers[mice[i].solver].plugin) pluginLoaded = 1;
+    }
+    Uint32 lastPluginCheck = SDL_GetTicks();
+    Uint64 lastFrame = SDL_GetPerformanceCounter();
     while(1)
     {
+        // While paused, sleep until an event arrives; a plugin solver also needs a timeout to keep the checks
+        // for a rebuilt plugin going
+        if(!running && pluginLoaded) SDL_WaitEventTimeout(NULL, PLUGIN_CHECK_INTERVAL);
+        else if(!running) SDL_WaitEvent(NULL);
+
         // Process event queue
         while(SDL_PollEvent(&e) != 0)
         {
@@ -94,7 +183,7 @@ int main(int argc, char** argv)
                 MIN_SCREEN_DIMENSION = (SCREEN_WIDTH <= SCREEN_HEIGHT) ? SCREEN_WIDTH : SCREEN_HEIGHT;
                 MAX_SCREEN_DIMENSION = (SCREEN_WIDTH <= SCREEN_HEIGHT) ? SCREEN_HEIGHT : SCREEN_WIDTH;
                 MAZE_WIDTH = MIN_SCREEN_DIMENSION - 2*MAZE_PADDING;
-                CELL_LENGTH = MAZE_WIDTH / maze.size;
+                updateCellLength();
 
                 // Calculate new maze origin
                 if(SCREEN_WIDTH >= SCREEN_HEIGHT)
@@ -108,18 +197,32 @@ int main(int argc, char** argv)
                     y_0 = (MAX_SCREEN_DIMENSION - MAZE_WIDTH)/2; 
                 }
 
-                // Update scaling factors
-                xCorrection = (float) SCREEN_WIDTH / (float) INIT_WIDTH;
-                yCorrection = (float) SCREEN_HEIGHT / (float) INIT_HEIGHT;
-
-                // Re-size maze texture and mouse bounding box
-                maze.mazeTexture = createMazeTexture(&maze);
-                updateRect(&mouse);
+                // Re-size maze texture and mouse bounding boxes
+                updateMazeTexture();
+                createFrameTexture();
+                for(int i = 0; i < mouseCount; i++) updateRect(&mice[i]);
 
                 // Display changes
                 renderScreen();
             }
 
+            // Redraw everything if the window was uncovered or the renderer lost the frame texture's contents
+            else if(e.type == SDL_WINDOWEVENT && e.window.event == SDL_WINDOWEVENT_EXPOSED)
+            {
+                fullRepaint = 1;
+                renderScreen();
+            }
+            else if(e.type == SDL_RENDER_TARGETS_RESET || e.type == SDL_RENDER_DEVICE_RESET)
+            {
+                if(e.type == SDL_RENDER_DEVICE_RESET)
+                {
+                    updateMazeTexture();
+                    createFrameTexture();
+                }
+                fullRepaint = 1;
+                renderScreen();
+            }
+
             // Handle key presses
             else if(e.type == SDL_KEYDOWN)
             {
@@ -128,6 +231,70 @@ int main(int argc, char** argv)
                     // S: toggle simulation
                     case SDLK_s:
                         running = !running;
+                        lastFrame = SDL_GetPerformanceCounter();
+                        break;
+
+                    // N: pause and run the mice until one of them finishes its next action
+                    case SDLK_n:
+                        running = 0;
+                        pendingTicks = 0;
+                        while(!stepMice());
+                        renderScreen();
+                        break;
+
+                    // +/-: change simulation speed
+                    case SDLK_EQUALS:
+                    case SDLK_PLUS:
+                    case SDLK_KP_PLUS:
+                        if(speedIndex < (int) (sizeof(SPEEDS) / sizeof(SPEEDS[0])) - 1) speedIndex++;
+                        printf("Speed: %gx\n", SPEEDS[speedIndex]);
+                        break;
+
+                    case SDLK_MINUS:
+                    case SDLK_KP_MINUS:
+                        if(speedIndex > 0) speedIndex--;
+                        printf("Speed: %gx\n", SPEEDS[speedIndex]);
+                        break;
+
+                    // Arrows, Page Up/Page Down, Home/End: seek through the trace being replayed
+                    case SDLK_LEFT:
+                    case SDLK_RIGHT:
+                    case SDLK_PAGEUP:
+                    case SDLK_PAGEDOWN:
+                    case SDLK_HOME:
+                    case SDLK_END:
+                        if(!replay.data) break;
+                        switch(e.key.keysym.sym)
+                        {
+                            case SDLK_LEFT: seekReplay((long long) replayStep - 1); break;
+                            case SDLK_RIGHT: seekReplay(replayStep + 1); break;
+                            case SDLK_PAGEUP: seekReplay((long long) replayStep - SEEK_STEPS); break;
+                            case SDLK_PAGEDOWN: seekReplay(replayStep + SEEK_STEPS); break;
+                            case SDLK_HOME: seekReplay(0); break;
+                            case SDLK_END: seekReplay(replay.steps); break;
+                        }
+                        lastFrame = SDL_GetPerformanceCounter();
+                        renderScreen();
+                        break;
+
+                    // H: toggle the timing overlay
+                    case SDLK_h:
+                        hudVisible = !hudVisible;
+                        timingEnabled = hudVisible || isTimingTraceOpen();
+                        renderScreen();
+                        break;
+
+                    // T: start or stop recording a timing trace for a trace viewer
+                    case SDLK_t:
+                        if(isTimingTraceOpen())
+                        {
+                            if(stopTimingTrace()) printf("Timing trace written to %s\n", timingTracePath);
+                        }
+                        else if(startTimingTrace(timingTracePath))
+                        {
+                            printf("Recording timing trace to %s; press t to stop\n", timingTracePath);
+                        }
+                        timingEnabled = hudVisible || isTimingTraceOpen();
                         break;
 
                     // D: Toggle darkmode
@@ -138,7 +305,8 @@ int main(int argc, char** argv)
                         WALL_COLOR.r = ~WALL_COLOR.r;
                         WALL_COLOR.g = ~WALL_COLOR.g;
                         WALL_COLOR.b = ~WALL_COLOR.b;
-                        maze.mazeTexture = createMazeTexture(&maze);
+                        updateMazeTexture();
+                        fullRepaint = 1;
                         renderScreen();
                         break;
 
@@ -154,33 +322,339 @@ int main(int argc, char** argv)
             }
         }
 
+        // Reload solver plugins that have been rebuilt and restart the race with the new code
+        if(pluginLoaded && SDL_GetTicks() - lastPluginCheck >= PLUGIN_CHECK_INTERVAL)
+        {
+            lastPluginCheck = SDL_GetTicks();
+            if(reloadSolverPlugins(mice, mouseCount))
+            {
+                restartMice();
+                renderScreen();
+            }
+        }
+
         if(running)
         {
-            // Render... the screen
-            renderScreen();
+            // Advance the simulation in fixed ticks by the time since the last frame, scaled by the speed, so
+            // the mouse moves at the same speed whatever the frame rate; fast speeds run many moves per frame
+            Uint64 now = SDL_GetPerformanceCounter();
+            double frameTime = (double) (now - lastFrame) * 1000 / SDL_GetPerformanceFrequency();
+            lastFrame = now;
+            markFrame();
+            if(frameTime > MAX_FRAME_TIME) frameTime = MAX_FRAME_TIME;
+            pendingTicks += frameTime * SPEEDS[speedIndex] / TICK_LENGTH;
+            uint64_t start = startTiming();
+            while(pendingTicks >= 1 && running)
+            {
+                stepMice();
+                pendingTicks--;
+            }
+            endTiming(STAGE_SIMULATE, start);
+            if(!running) pendingTicks = 0;
 
-            // Animation delay
-            SDL_Delay(5);
+            for(int i = 0; i < mouseCount; i++)
+            {
+                if(goalReported[i] || !isGoal(&maze, motions[i].x, motions[i].y)) continue;
+                if(mouseCount == 1) printf("Reached goal after %.2f s\n", motions[i].time);
+                else
+                {
+                    printf("Mouse %d (%s) reached goal after %.2f s\n", i + 1, solvers[mice[i].solver].name,
+                           motions[i].time);
+                }
+                goalReported[i] = 1;
+            }
+
+            // Pause once every mouse has reached the goal or settled into idling, so the loop goes back to
+            // sleeping until an event arrives instead of redrawing an unchanging screen
+            int finished = 1;
+            for(int i = 0; i < mouseCount && finished; i++)
+            {
+                const MotionState *motion = &motions[i];
+                int idling = motion->time > 0 && mice[i].action == IDLE && !motion->cells && !motion->turn;
+                finished = goalReported[i] || idling;
+            }
+            if(finished && running && !finishPaused)
+            {
+                running = 0;
+                finishPaused = 1;
+                pendingTicks = 0;
+                printf("All mice have reached the goal or stopped; press s to keep running\n");
+            }
+
+            // Render... the screen, which waits for the display refresh if vsync is on
+            renderScreen();
+            if(!vsync)
+            {
+                double renderTime = (double) (SDL_GetPerformanceCounter() - now) * 1000 / SDL_GetPerformanceFrequency();
+                if(renderTime < FRAME_TIME) SDL_Delay(FRAME_TIME - renderTime);
+            }
         }
     }
 
     return 0;
 }
 
-void renderScreen()
+// Adds mice running the solver given as [COUNT*]SOLVER[:SETTINGS]: COUNT mice (default 1) with the motion
+// settings SETTINGS, as for headless --motion, where a range such as speed=1..3 is spread evenly over the mice
+// Returns 1 on success, 0 if the solver or settings are invalid or memory could not be allocated
+int addMice(const char *spec)
 {
-    // Prepare new render frame
-    SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
-    SDL_RenderClear(renderer);
+    int count = 1;
+    const char *star = strchr(spec, '*');
+    if(star)
+    {
+        count = atoi(spec);
+        spec = star + 1;
+    }
+    if(count < 1 || count > MAX_MICE - mouseCount)
+    {
+        printf("Error: at most %d mice can race at once\n", MAX_MICE);
+        return 0;
+    }
+
+    char name[512], settings[512] = "";
+    const char *colon = strchr(spec, ':');
+    snprintf(name, sizeof(name), "%.*s", colon ? (int) (colon - spec) : (int) strlen(spec), spec);
+    if(colon) snprintf(settings, sizeof(settings), "%s", colon + 1);
+    int solverIndex = findOrLoadSolver(name);
+    if(solverIndex < 0)
+    {
+        printf("Error: unknown solver %s\n", name);
+        return 0;
+    }
+
+    // The arrays may move, so pointers between them are only set once all mice have been added
+    int total = mouseCount + count;
+    Mouse *newMice = realloc(mice, sizeof(Mouse) * total);
+    if(newMice) mice = newMice;
+    SolverState *newStates = realloc(solverStates, sizeof(SolverState) * total);
+    if(newStates) solverStates = newStates;
+    MotionState *newMotions = realloc(motions, sizeof(MotionState) * total);
+    if(newMotions) motions = newMotions;
+    int *newReported = realloc(goalReported, sizeof(int) * total);
+    if(newReported) goalReported = newReported;
+    if(!newMice || !newStates || !newMotions || !newReported)
+    {
+        printf("Error: unable to allocate %d mice\n", total);
+        return 0;
+    }
 
-    // Render maze to frame
-    renderMaze(&maze);
+    // Every mouse's body moves at 1x speed in real time
+    for(int i = 0; i < count; i++)
+    {
+        char expanded[1024];
+        MotionProfile profile = defaultMotionProfile;
+        if(!spreadSettings(settings, i, count, expanded, sizeof(expanded)))
+        {
+            printf("Error: motion settings %s are too long\n", settings);
+            return 0;
+        }
+        if(!parseMotionProfile(expanded, &profile)) return 0;
+        profile.timeStep = TICK_LENGTH / 1000.0;
+
+        int m = mouseCount++;
+        memset(&mice[m], 0, sizeof(Mouse));
+        memset(&solverStates[m], 0, sizeof(SolverState));
+        initMotion(&motions[m], &profile);
+        goalReported[m] = 0;
+        mice[m].solver = solverIndex;
+        mice[m].color = getMouseColor(m);
+    }
+    return 1;
+}
+
+// Writes the motion settings of mouse index of count, replacing each range LOW..HIGH with a value spread
+// evenly from LOW for the first mouse to HIGH for the last
+// Returns 1 on success, 0 if the settings do not fit in out
+int spreadSettings(const char *settings, int index, int count, char *out, size_t size)
+{
+    char copy[512];
+    snprintf(copy, sizeof(copy), "%s", settings);
+    size_t used = 0;
+    out[0] = '\0';
 
-    // Render mouse if it is in motion, otherwise poll solver for next mouse action
-    if(!renderMouse(&mouse)) getNextAction(&mouse);
+    for(char *setting = strtok(copy, ","); setting; setting = strtok(NULL, ","))
+    {
+        char *equals = strchr(setting, '=');
+        char *range = strstr(setting, "..");
+        if(equals && range > equals)
+        {
+            double low = atof(equals + 1), high = atof(range + 2);
+            double value = count > 1 ? low + (high - low) * index / (count - 1) : low;
+            used += snprintf(out + used, size - used, "%s%.*s%g", used ? "," : "", (int) (equals + 1 - setting),
+                             setting, value);
+        }
+        else used += snprintf(out + used, size - used, "%s%s", used ? "," : "", setting);
+        if(used >= size) return 0;
+    }
+    return 1;
+}
+
+// Returns the color of a mouse's trail; hues step by the golden ratio so any number of mice get distinct ones
+SDL_Color getMouseColor(int index)
+{
+    float hue = fmodf(index * 0.618034f, 1) * 6, saturation = 0.8, value = 0.85;
+    int sector = hue;
+    float f = hue - sector;
+    float p = value * (1 - saturation), q = value * (1 - saturation * f), t = value * (1 - saturation * (1 - f));
+    float rgb[6][3] = {{value, t, p}, {q, value, p}, {p, value, t}, {p, q, value}, {t, p, value}, {value, p, q}};
+
+    SDL_Color color = {rgb[sector][0] * 255, rgb[sector][1] * 255, rgb[sector][2] * 255, 255};
+    return color;
+}
+
+// Advances every mouse by one simulation tick
+// Returns 1 if any mouse reached a cell center or finished a turn or idle in this tick, 0 otherwise
+int stepMice()
+{
+    int done = 0;
+    for(int i = 0; i < mouseCount; i++) done |= stepMouse(&mice[i]);
+    return done;
+}
+
+// Puts every mouse back at the start with a fresh solver, restarting the race
+void restartMice()
+{
+    for(int i = 0; i < mouseCount; i++)
+    {
+        placeMouse(&mice[i], 0, 0, NORTH);
+        resetSolver(&mice[i]);
+        goalReported[i] = 0;
+        updateRect(&mice[i]);
+    }
+    finishPaused = 0;
+}
 
-    // Display render frame to screen
+// Solver used to replay a trace: returns the recorded decisions in order, then idles
+Action replaySolver(Mouse *mouse)
+{
+    (void) mouse;
+    int action = getTraceAction(&replay, replayStep);
+    if(action < 0) return IDLE;
+    replayStep++;
+    return action;
+}
+
+// Puts the mouse at rest where it was at the given step of the trace being replayed (clamped to the trace), so
+// the replay continues from there
+void seekReplay(long long step)
+{
+    if(step < 0) step = 0;
+    if(step > (long long) replay.steps) step = replay.steps;
+
+    TraceState state;
+    if(!seekTrace(&replay, step, &state)) return;
+    replayStep = step;
+    placeMouse(&mice[0], state.x, state.y, state.heading);
+    pendingTicks = 0;
+    goalReported[0] = 0;
+    finishPaused = 0;
+    updateRect(&mice[0]);
+    printf("Step %llu of %llu\n", (unsigned long long) step, (unsigned long long) replay.steps);
+}
+
+// Fit cells to the maze area, thinning walls so large mazes stay legible
+void updateCellLength()
+{
+    CELL_LENGTH = MAZE_WIDTH / maze.size;
+    if(CELL_LENGTH < 2) CELL_LENGTH = 2;
+
+    WALL_THICKNESS = CELL_LENGTH / 4;
+    if(WALL_THICKNESS > MAX_WALL_THICKNESS) WALL_THICKNESS = MAX_WALL_THICKNESS;
+    if(WALL_THICKNESS < 1) WALL_THICKNESS = 1;
+}
+
+void renderScreen()
+{
+    // Without a frame texture (render targets unsupported), redraw the whole screen every frame
+    // Each stage is timed while the timing overlay or a timing trace is on
+    uint64_t start = startTiming();
+    if(!frameTexture)
+    {
+        SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
+        SDL_RenderClear(renderer);
+        renderMaze(&maze);
+        endTiming(STAGE_MAZE, start);
+
+        start = startTiming();
+        for(int i = 0; i < mouseCount; i++) updateMousePose(&mice[i], pendingTicks);
+        renderMice(mice, mouseCount);
+        endTiming(STAGE_MOUSE, start);
+
+        start = startTiming();
+        if(hudVisible) renderHud(0, 0);
+        endTiming(STAGE_HUD, start);
+
+        start = startTiming();
+        SDL_RenderPresent(renderer);
+        endTiming(STAGE_PRESENT, start);
+        return;
+    }
+
+    // Prepare new render frame: either redraw the maze or erase what was drawn over it in the last frame
+    SDL_SetRenderTarget(renderer, frameTexture);
+    if(fullRepaint) renderMaze(&maze);
+    else
+    {
+        for(int i = 0; i < dirtyCount; i++) SDL_RenderCopy(renderer, maze.mazeTexture, &dirtyRects[i], &dirtyRects[i]);
+    }
+    fullRepaint = 0;
+    dirtyCount = 0;
+    endTiming(STAGE_MAZE, start);
+
+    // Render mice part way through their current actions; with more mice than dirty rectangles, the next frame
+    // is a full repaint, which costs a single copy of the maze texture
+    start = startTiming();
+    for(int i = 0; i < mouseCount; i++)
+    {
+        updateMousePose(&mice[i], pendingTicks);
+        markDirty(getMouseBounds(&mice[i]));
+    }
+    renderMice(mice, mouseCount);
+    endTiming(STAGE_MOUSE, start);
+
+    // Draw the timing overlay in the top left corner; it changes every frame, so it is erased like the mouse
+    start = startTiming();
+    if(hudVisible) markDirty(renderHud(0, 0));
+    endTiming(STAGE_HUD, start);
+
+    // Display render frame to screen. SDL does not keep the renderer's back buffer between presents, so the frame
+    // texture is copied whole every frame; what the dirty areas save is redrawing the maze's walls and posts, not
+    // the copy to the display
+    start = startTiming();
+    SDL_SetRenderTarget(renderer, NULL);
+    SDL_RenderCopy(renderer, frameTexture, NULL, NULL);
     SDL_RenderPresent(renderer);
+    endTiming(STAGE_PRESENT, start);
+}
+
+// (Re)creates the frame texture to match the screen size; it starts blank, so the next frame is a full repaint
+void createFrameTexture()
+{
+    if(frameTexture) SDL_DestroyTexture(frameTexture);
+    frameTexture = NULL;
+    fullRepaint = 1;
+
+    if(!SDL_RenderTargetSupported(renderer)) return;
+    frameTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, SCREEN_WIDTH, SCREEN_HEIGHT);
+    if(frameTexture == NULL) printf("Error creating frame texture, redrawing full frames: %s\n", SDL_GetError());
+}
+
+// (Re)creates the maze texture to match the maze, screen size and wall color, destroying the old one
+void updateMazeTexture()
+{
+    if(maze.mazeTexture) SDL_DestroyTexture(maze.mazeTexture);
+    maze.mazeTexture = createMazeTexture(&maze);
+}
+
+// Records a screen area drawn over in the current frame, to be restored from the maze texture in the next one
+void markDirty(SDL_Rect rect)
+{
+    SDL_Rect screen = {0, 0, SCREEN_WIDTH, SCREEN_HEIGHT};
+    if(!SDL_IntersectRect(&rect, &screen, &rect)) return;
+
+    if(dirtyCount < MAX_DIRTY_RECTS) dirtyRects[dirtyCount++] = rect;
+    else fullRepaint = 1;
 }
 
 // Initialize graphics environment
@@ -217,14 +691,20 @@ int init()
         return 0;
     }
     
-    // Initialize renderer
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    // Initialize renderer, falling back to software rendering where there is no graphics acceleration (such as
+    // remote displays) or SDL_RENDER_DRIVER asks for it
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+    if(renderer == NULL) renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
     if(renderer == NULL)
     {
         printf("Error creating renderer: %s\n", SDL_GetError());
         return 0;
     }
 
+    // Frames are paced by the display refresh if the renderer supports it, otherwise by FRAME_TIME
+    SDL_RendererInfo info;
+    vsync = !SDL_GetRendererInfo(renderer, &info) && (info.flags & SDL_RENDERER_PRESENTVSYNC);
+
     // Initialize SDL image
     SDL_SetRenderDrawColor(renderer, 0xFF, 0xFF, 0xFF, 0xFF);
     int imgFlags = IMG_INIT_PNG;
@@ -240,6 +720,11 @@ int init()
 // Free up resources and quit SDL
 int quit()
 {
+    stopTimingTrace();
+    if(frameTexture) SDL_DestroyTexture(frameTexture);
+    frameTexture = NULL;
+    if(maze.mazeTexture) SDL_DestroyTexture(maze.mazeTexture);
+    maze.mazeTexture = NULL;
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     window = NULL;
@@ -1,120 +1,588 @@
 #include "maze.h"
+#include "mouse.h"
+#include "pack.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdarg.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // Access global variables from main.c
 extern int SCREEN_WIDTH, SCREEN_HEIGHT, MAZE_PADDING, WALL_THICKNESS, MAX_MAZE_SIZE, MIN_MAZE_SIZE, MIN_SCREEN_DIMENSION, MAX_SCREEN_DIMENSION, MAZE_WIDTH, CELL_LENGTH, x_0, y_0;
-extern SDL_Renderer* renderer;
 extern char *mazeDirectory;
+#ifndef HEADLESS
+extern SDL_Renderer* renderer;
 extern SDL_Color BACKGROUND_COLOR, WALL_COLOR;
+#endif
+
+int mazeMessages = 1;   // 1 to print progress messages while loading, 0 to only print errors
+
+// Cursor over the lines of a memory-mapped maze file
+typedef struct
+{
+    const char *next;       // Start of the next line
+    const char *end;        // End of the file
+    const char *filePath;
+    int number;             // Number of the line last read, starting at 1
+} LineReader;
+
+// Reads the next line without its line ending (\n or \r\n)
+// Returns 1 if there was another line, 0 at the end of the file
+static int readLine(LineReader *reader, const char **line, int *length)
+{
+    if(reader->next >= reader->end) return 0;
+
+    const char *start = reader->next;
+    const char *newline = memchr(start, '\n', reader->end - start);
+    const char *stop = newline ? newline : reader->end;
+    reader->next = newline ? newline + 1 : reader->end;
+    if(stop > start && stop[-1] == '\r') stop--;
+
+    *line = start;
+    *length = stop - start;
+    reader->number++;
+    return 1;
+}
+
+// Prints a parse error at the given column (starting at 1) of the line last read
+// Always returns 0 so callers can return its result
+static int parseError(LineReader *reader, int column, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    printf("Error: %s line %d, column %d: ", reader->filePath, reader->number, column);
+    vprintf(format, args);
+    printf("\n");
+    va_end(args);
+    return 0;
+}
+
+// Returns 1 if the wall post at column c of wall line r (counting from the top border line) touches a wall
+// line is wall line r; above and below are the neighboring wall lines, NULL past the borders
+static int postTouchesWall(const char *line, int length, const char *above, int aboveLength, const char *below,
+                           int belowLength, int c)
+{
+    if(c > 0 && line[c - 1] == 'x') return 1;
+    if(c + 1 < length && line[c + 1] == 'x') return 1;
+    if(above && c < aboveLength && above[c] == 'x') return 1;
+    if(below && c < belowLength && below[c] == 'x') return 1;
+    return 0;
+}
+
+// Parses maze text straight into the maze's wall storage in a single pass, rejecting anything that does not
+// follow the maze file format (see Mazes/README.md)
+// Returns 1 on success, 0 after printing the line and column of the first problem found
+static int parseMaze(Maze *maze, LineReader *reader)
+{
+    const char *line;
+    int length;
+
+    // Maze name (1st line)
+    if(!readLine(reader, &line, &length)) return parseError(reader, 1, "missing maze name");
+    if(length >= (int) sizeof(maze->name))
+    {
+        return parseError(reader, sizeof(maze->name), "maze name is longer than %d characters", (int) sizeof(maze->name) - 1);
+    }
+    memcpy(maze->name, line, length);
+    maze->name[length] = '\0';
+
+    // Maze size (2nd line)
+    if(!readLine(reader, &line, &length)) return parseError(reader, 1, "missing maze size");
+    int mazeSize = 0;
+    for(int c = 0; c < length; c++)
+    {
+        if(line[c] < '0' || line[c] > '9') return parseError(reader, c + 1, "maze size must be a whole number");
+        if(mazeSize <= MAX_MAZE_SIZE) mazeSize = mazeSize * 10 + line[c] - '0';
+    }
+    if(length == 0) return parseError(reader, 1, "missing maze size");
+    if(mazeSize < MIN_MAZE_SIZE || mazeSize > MAX_MAZE_SIZE)
+    {
+        return parseError(reader, 1, "maze size must be between %d and %d", MIN_MAZE_SIZE, MAX_MAZE_SIZE);
+    }
+
+    if(mazeMessages)
+    {
+        printf("Maze name: %s\n", maze->name);
+        printf("Maze size: %d\n", mazeSize);
+    }
+
+#ifndef HEADLESS
+    maze->mazeTexture = NULL;
+#endif
+    if(!clearMaze(maze, mazeSize)) return 0;
+
+    // Wall lines: 2n + 1 lines alternating between horizontal walls (even lines, starting with the top border)
+    // and vertical walls (odd lines). Columns alternate between wall posts (even) and cells or walls (odd), except
+    // that Editor-saved horizontal lines draw each wall as two characters ("xx") and are 2n + 3 characters long
+    // File rows run top to bottom, so wall line r describes maze row y = mazeSize - 1 - r / 2 (for horizontal
+    // lines, the row below the line)
+    int width = 2 * mazeSize + 1;
+    const char *above = NULL;
+    int aboveLength = 0;
+    for(int r = 0; r < width; r++)
+    {
+        if(!readLine(reader, &line, &length))
+        {
+            return parseError(reader, 1, "file ends after %d of %d wall lines", r, width);
+        }
+
+        for(int c = 0; c < length; c++)
+        {
+            if(line[c] != 'x' && line[c] != ' ') return parseError(reader, c + 1, "unexpected character '%c'", line[c]);
+        }
+
+        int y = mazeSize - 1 - r / 2;
+        int border = (r == 0 || r == width - 1);
+        int pairs = (r % 2 == 0 && !border && length == width + 2);
+        if(length != width && !pairs)
+        {
+            // Point at the first missing or extra character
+            int longest = (r % 2 == 0 && !border) ? width + 2 : width;
+            int column = (length < width ? length : length > longest ? longest : width) + 1;
+            if(longest > width)
+            {
+                return parseError(reader, column, "expected %d or %d characters, found %d", width, longest, length);
+            }
+            return parseError(reader, column, "expected %d characters, found %d", width, length);
+        }
+
+        if(line[0] != 'x') return parseError(reader, 1, "gap in border wall");
+        if(line[length - 1] != 'x') return parseError(reader, length, "gap in border wall");
+
+        if(border)
+        {
+            const char *gap = memchr(line, ' ', length);
+            if(gap) return parseError(reader, gap - line + 1, "gap in border wall");
+        }
+        else if(r % 2 == 1)
+        {
+            // Vertical walls: even columns are walls east of cell c / 2 - 1, odd columns are cell interiors
+            for(int c = 1; c < width - 1; c++)
+            {
+                if(c % 2 == 1 && line[c] != ' ') return parseError(reader, c + 1, "wall inside cell");
+                if(c % 2 == 0 && line[c] == 'x') setWall(maze, c / 2 - 1, y, EAST, 1);
+            }
+        }
+        else if(pairs)
+        {
+            // Editor horizontal walls: columns 2k + 1 and 2k + 2 both describe the wall north of cell k
+            for(int k = 0; k < mazeSize; k++)
+            {
+                if(line[2 * k + 1] != line[2 * k + 2]) return parseError(reader, 2 * k + 2, "wall halves do not match");
+                if(line[2 * k + 1] == 'x') setWall(maze, k, y, NORTH, 1);
+            }
+        }
+        else
+        {
+            // Horizontal walls: odd columns are walls north of cell c / 2, even columns are wall posts, which
+            // must touch a wall if drawn
+            LineReader peek = *reader;
+            const char *below = NULL;
+            int belowLength = 0;
+            readLine(&peek, &below, &belowLength);
+            for(int c = 1; c < width - 1; c++)
+            {
+                if(c % 2 == 1 && line[c] == 'x') setWall(maze, c / 2, y, NORTH, 1);
+                if(c % 2 == 0 && line[c] == 'x' && !postTouchesWall(line, length, above, aboveLength, below, belowLength, c))
+                {
+                    return parseError(reader, c + 1, "wall post does not touch any wall");
+                }
+            }
+        }
+
+        above = line;
+        aboveLength = length;
+    }
+
+    // Only blank lines may follow the maze
+    while(readLine(reader, &line, &length))
+    {
+        for(int c = 0; c < length; c++)
+        {
+            if(line[c] != ' ' && line[c] != '\t') return parseError(reader, c + 1, "unexpected text after maze");
+        }
+    }
+
+    return 1;
+}
 
 // Load maze from specified path if path is provided
+// The file is memory-mapped and parsed in place; returns 1 on success, 0 if it could not be read or is malformed
 int loadMaze(Maze *maze, const char *path)
 {
     // If maze pointer passed in was NULL, exit
     if(maze == NULL) return 0;
 
-    // File loading variables
-    FILE *file;
-    char *buffer = (char *) malloc(64);;
-    char *filePath[100] = {0};
-    int lineLength = 0;
-    int mazeSize = 0;
-
     // Load specified maze file or default one if NULL path provided
-    strcat(filePath, mazeDirectory);
-    if(path) strcat(filePath, path);
-    else strcat(filePath, "default.txt");
+    char filePath[512];
+    snprintf(filePath, sizeof(filePath), "%s%s", mazeDirectory, path ? path : "default.txt");
 
-    // Open maze file
-    file = fopen(filePath, "r");
-    if(!file)
+    // Mazes can also be opened straight from a pack file as PACK:NAME or PACK:INDEX
+    if(strstr(filePath, ".pack:")) return loadMazeFromPack(maze, filePath);
+
+    // Map maze file into memory
+    int file = open(filePath, O_RDONLY);
+    struct stat info;
+    if(file < 0 || fstat(file, &info))
     {
         printf("Error: Could not open file %s\n", filePath);
-        exit(-1);
+        if(file >= 0) close(file);
+        return 0;
+    }
+    if(info.st_size == 0)
+    {
+        printf("Error: %s is empty\n", filePath);
+        close(file);
+        return 0;
+    }
+    char *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(data == MAP_FAILED)
+    {
+        printf("Error: Could not read file %s\n", filePath);
+        return 0;
     }
-    
-    printf("Successfully opened file %s\n", filePath);
 
-    // Read maze name from file (1st line) and copy to maze's name array
-    fscanf(file, "%[^\n]", buffer);
-    strncpy(maze->name, buffer, 64);
+    if(mazeMessages) printf("Successfully opened file %s\n", filePath);
 
-    // Read maze size from file (2nd line) and copy to maze's size variable
-    fscanf(file, "%d", &(maze->size));
-    mazeSize = maze->size;
+    LineReader reader = {data, data + info.st_size, filePath, 0};
+    int result = parseMaze(maze, &reader);
+    munmap(data, info.st_size);
+    if(result) updateRays(maze);
 
-    // Ensure maze size is valid
-    if(mazeSize < MIN_MAZE_SIZE || mazeSize > MAX_MAZE_SIZE)
+    return result;
+}
+
+// Save maze to the maze folder in the same layout as the Editor's saveMaze, so files written by either
+// program can be opened by both
+int saveMaze(Maze *maze, const char *path)
+{
+    // If maze pointer passed in was NULL, exit
+    if(maze == NULL) return 0;
+
+    char filePath[512];
+    snprintf(filePath, sizeof(filePath), "%s%s", mazeDirectory, path);
+
+    FILE *file = fopen(filePath, "w");
+    if(!file)
     {
-        printf("Error: Invalid maze size\n");
-        fclose(file);
+        printf("Error: Could not open or create file %s\n", filePath);
         return 0;
     }
 
-    // Print maze name and size to terminal
-    printf("Maze name: %s\n", maze->name);
-    printf("Maze size: %d\n", maze->size);
-    
-    // Maze loading variables
-    maze->mazeTexture = NULL;
-    int h_walls[17][16] = {0};
-    int v_walls[16][17] = {0};
-    char *hBuff = (char *) malloc(34);
-    char *vBuff = (char *) malloc(34);
-    int hCounter;
-    int vCounter;
+    int mazeSize = maze->size;
+    fprintf(file, "%s\n%d\n", maze->name, mazeSize);
 
-    // Get rid of first line (top border wall)
-    getline(&buffer, &lineLength, file);
-    getline(&buffer, &lineLength, file);
+    // Create top border wall
+    for(int i = 0; i < 2*mazeSize+1; i++) fputc('x', file);
+    fputc('\n', file);
 
-    // Process two lines at a time up to second-to-last line and detect horizontal and vertical walls
-    for(int i = 0; i < mazeSize - 1; i++)
+    // Write each row of vertical walls followed by the horizontal walls below it; file rows run top to bottom
+    for(int y = mazeSize - 1; y >= 0; y--)
     {
-        getline(&vBuff, &lineLength, file);
-        getline(&hBuff, &lineLength, file);
-        
-        vCounter = 0;
-        for(int j = 2; j <= 2*mazeSize - 1; j += 2)
+        fputc('x', file);
+        for(int x = 0; x < mazeSize - 1; x++)
         {
-            if(vBuff[j] == 'x') v_walls[i][vCounter] = 1;
-            vCounter++;
+            fputc(' ', file);
+            fputc(hasWall(maze, x, y, EAST) ? 'x' : ' ', file);
         }
+        fputs(" x\n", file);
+
+        if(y == 0) break;
+        fputc('x', file);
+        for(int x = 0; x < mazeSize; x++) fputs(hasWall(maze, x, y, SOUTH) ? "xx" : "  ", file);
+        fputs(" x\n", file);
+    }
+
+    // Create bottom border wall
+    for(int i = 0; i < 2*mazeSize+1; i++) fputc('x', file);
+    fputc('\n', file);
+
+    return fclose(file) == 0;
+}
+
+// Clears every wall of a maze, then adds the border walls
+static void resetWalls(Maze *maze)
+{
+    int size = maze->size;
+    memset(maze->walls, 0, ((size_t) size * size + 1) / 2);
+    memset(maze->northWalls, 0, sizeof(uint64_t) * maze->rowWords * size);
+    memset(maze->eastWalls, 0, sizeof(uint64_t) * maze->rowWords * size);
+
+    for(int i = 0; i < size; i++)
+    {
+        setWall(maze, i, 0, SOUTH, 1);
+        setWall(maze, i, size - 1, NORTH, 1);
+        setWall(maze, 0, i, WEST, 1);
+        setWall(maze, size - 1, i, EAST, 1);
+    }
+}
+
+// Reset maze to an empty maze of the given size surrounded by border walls, (re)allocating wall storage
+// Returns 1 on success, 0 if memory could not be allocated
+int clearMaze(Maze *maze, int size)
+{
+    int rowWords = (size + 63) / 64;
+    size_t wallBytes = ((size_t) size * size + 1) / 2;
+    size_t rowBytes = sizeof(uint64_t) * rowWords * size;
+
+    uint8_t *walls = realloc(maze->walls, wallBytes);
+    if(walls) maze->walls = walls;
+    uint64_t *northWalls = realloc(maze->northWalls, rowBytes);
+    if(northWalls) maze->northWalls = northWalls;
+    uint64_t *eastWalls = realloc(maze->eastWalls, rowBytes);
+    if(eastWalls) maze->eastWalls = eastWalls;
+    if(!walls || !northWalls || !eastWalls)
+    {
+        printf("Error: Unable to allocate memory for %dx%d maze\n", size, size);
+        return 0;
+    }
+
+    maze->size = size;
+    maze->rowWords = rowWords;
+    resetWalls(maze);
+    return 1;
+}
+
+// Returns the bytes of wall storage a maze of the given size needs (see initMazeIn)
+size_t getMazeStorageSize(int size)
+{
+    int rowWords = (size + 63) / 64;
+    size_t rowBytes = sizeof(uint64_t) * rowWords * size;
+    return 2 * rowBytes + ((size_t) size * size + 1) / 2;
+}
+
+// Sets up an empty maze of the given size surrounded by border walls in storage provided by the caller, which
+// must hold getMazeStorageSize(size) bytes and be 8-byte aligned. The maze has no ray table, and freeMaze must
+// not be called on it
+void initMazeIn(Maze *maze, int size, void *storage)
+{
+    int rowWords = (size + 63) / 64;
+    size_t rowBytes = sizeof(uint64_t) * rowWords * size;
+
+    *maze = (Maze) {0};
+    maze->size = size;
+    maze->rowWords = rowWords;
+    maze->northWalls = storage;
+    maze->eastWalls = (uint64_t *) ((char *) storage + rowBytes);
+    maze->walls = (uint8_t *) storage + 2 * rowBytes;
+    resetWalls(maze);
+}
+
+// Free wall storage
+void freeMaze(Maze *maze)
+{
+    free(maze->walls);
+    free(maze->northWalls);
+    free(maze->eastWalls);
+    free(maze->rays);
+    maze->walls = NULL;
+    maze->northWalls = NULL;
+    maze->eastWalls = NULL;
+    maze->rays = NULL;
+    maze->raysValid = 0;
+    maze->size = 0;
+}
+
+// Sets or clears one bit of a cell's packed wall mask
+static void setCellBit(Maze *maze, int x, int y, int direction, int present)
+{
+    int i = y * maze->size + x;
+    uint8_t bit = (1 << direction) << ((i & 1) << 2);
+    if(present) maze->walls[i >> 1] |= bit;
+    else maze->walls[i >> 1] &= ~bit;
+}
+
+// Sets or clears the wall on the given side of cell (x, y), keeping the neighboring cell and row bitsets consistent
+void setWall(Maze *maze, int x, int y, int direction, int present)
+{
+    int size = maze->size;
+    maze->raysValid = 0;
+    setCellBit(maze, x, y, direction, present);
+
+    // Each wall is shared with the neighboring cell, which sees it in the opposite direction
+    int nx = x, ny = y;
+    switch(direction)
+    {
+        case NORTH: ny++; break;
+        case EAST: nx++; break;
+        case SOUTH: ny--; break;
+        case WEST: nx--; break;
+    }
+    if(nx >= 0 && nx < size && ny >= 0 && ny < size) setCellBit(maze, nx, ny, (direction + 2) % 4, present);
+
+    // Row bitsets only record north and east walls; south and west walls belong to the neighboring cell
+    uint64_t *row = NULL;
+    int bx = x, by = y;
+    switch(direction)
+    {
+        case NORTH: row = maze->northWalls; break;
+        case EAST: row = maze->eastWalls; break;
+        case SOUTH: row = maze->northWalls; by = y - 1; break;
+        case WEST: row = maze->eastWalls; bx = x - 1; break;
+    }
+    if(bx < 0 || by < 0) return;
+    uint64_t *word = &row[by * maze->rowWords + (bx >> 6)];
+    if(present) *word |= 1ULL << (bx & 63);
+    else *word &= ~(1ULL << (bx & 63));
+}
 
-        hCounter = 0;
-        for(int k = 1; k <= 2*mazeSize + 1; k += 2)
+// Recomputes every cell's wall mask and the sensor rays from the north and east wall bitsets, so mazes can be
+// built a row of bits at a time instead of a wall at a time with setWall
+void updateCellWalls(Maze *maze)
+{
+    int size = maze->size;
+    memset(maze->walls, 0, ((size_t) size * size + 1) / 2);
+    for(int y = 0; y < size; y++)
+    {
+        const uint64_t *north = &maze->northWalls[y * maze->rowWords];
+        const uint64_t *south = y > 0 ? north - maze->rowWords : NULL;
+        const uint64_t *east = &maze->eastWalls[y * maze->rowWords];
+        for(int x = 0; x < size; x++)
         {
-            if(hBuff[k] == 'x') h_walls[i][hCounter] = 1;
-            hCounter++;
+            int mask = 0;
+            if((north[x >> 6] >> (x & 63)) & 1) mask |= WALL_NORTH;
+            if((east[x >> 6] >> (x & 63)) & 1) mask |= WALL_EAST;
+            if(!south || (south[x >> 6] >> (x & 63)) & 1) mask |= WALL_SOUTH;
+            if(x == 0 || (east[(x - 1) >> 6] >> ((x - 1) & 63)) & 1) mask |= WALL_WEST;
+
+            int i = y * size + x;
+            maze->walls[i >> 1] |= mask << ((i & 1) << 2);
         }
     }
 
-    // Process last line (bottom maze row with vertical walls)
-    getline(&vBuff, &lineLength, file);
-    vCounter = 0;
-    for(int i = 2; i <= 2*mazeSize - 1; i += 2)
+    updateRays(maze);
+}
+
+// Rebuilds the sensor ray table: each cell sees one cell further than its neighbor in the same direction
+// unless there is a wall in between, so every direction is filled in one sweep starting from the far side
+// Returns 1 on success, 0 if memory could not be allocated, in which case distances are traced wall by wall
+int updateRays(Maze *maze)
+{
+    int size = maze->size;
+    maze->raysValid = 0;
+    uint16_t *rays = realloc(maze->rays, sizeof(uint16_t) * 4 * size * size);
+    if(!rays) return 0;
+    maze->rays = rays;
+
+    for(int y = size - 1; y >= 0; y--)
     {
-        if(vBuff[i] == 'x') v_walls[mazeSize - 1][vCounter] = 1;
-        vCounter++;
+        for(int x = 0; x < size; x++)
+        {
+            int i = y * size + x;
+            rays[i * 4 + NORTH] = y == size - 1 || hasWall(maze, x, y, NORTH) ? 0 : rays[(i + size) * 4 + NORTH] + 1;
+        }
+    }
+    for(int y = 0; y < size; y++)
+    {
+        for(int x = 0; x < size; x++)
+        {
+            int i = y * size + x;
+            rays[i * 4 + SOUTH] = y == 0 || hasWall(maze, x, y, SOUTH) ? 0 : rays[(i - size) * 4 + SOUTH] + 1;
+            rays[i * 4 + WEST] = x == 0 || hasWall(maze, x, y, WEST) ? 0 : rays[(i - 1) * 4 + WEST] + 1;
+        }
+        for(int x = size - 1; x >= 0; x--)
+        {
+            int i = y * size + x;
+            rays[i * 4 + EAST] = x == size - 1 || hasWall(maze, x, y, EAST) ? 0 : rays[(i + 1) * 4 + EAST] + 1;
+        }
     }
 
-    // Free temporary buffers
-    free(buffer);
-    free(hBuff);
-    free(vBuff);
+    maze->raysValid = 1;
+    return 1;
+}
 
-    // Store wall data into maze's wall arrays
-    memcpy(maze->hWalls, h_walls, sizeof(int) * 17 * 16);
-    memcpy(maze->vWalls, v_walls, sizeof(int) * 17 * 16);
+// Counts the cells between cell (x, y) and the nearest wall in the given direction by walking towards it; used
+// while the ray table is stale
+int traceWallDistance(const Maze *maze, int x, int y, int direction)
+{
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {1, 0, -1, 0};
+    int distance = 0;
+    while(!hasWall(maze, x, y, direction))
+    {
+        x += dx[direction];
+        y += dy[direction];
+        if(x < 0 || x >= maze->size || y < 0 || y >= maze->size) break;
+        distance++;
+    }
 
-    // Close file
-    fclose(file);
+    return distance;
+}
 
-    return 1;
+// Returns 1 if cell (x, y) is one of the center goal cells, 0 otherwise
+int isGoal(Maze *maze, int x, int y)
+{
+    int lo = (maze->size - 1) / 2;
+    int hi = maze->size / 2;
+    return x >= lo && x <= hi && y >= lo && y <= hi;
+}
+
+// Compare maze file names for sorting
+static int compareNames(const void *a, const void *b)
+{
+    return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+// Lists the .txt files in the maze folder in alphabetical order
+// Returns the number of files found, or -1 if the folder could not be read
+int listMazes(char ***names)
+{
+    DIR *dir = opendir(mazeDirectory);
+    if(!dir) return -1;
+
+    int count = 0, capacity = 16;
+    *names = malloc(sizeof(char *) * capacity);
+    struct dirent *entry;
+    while((entry = readdir(dir)) != NULL)
+    {
+        size_t length = strlen(entry->d_name);
+        if(length < 5 || strcmp(entry->d_name + length - 4, ".txt")) continue;
+
+        if(count == capacity)
+        {
+            capacity *= 2;
+            *names = realloc(*names, sizeof(char *) * capacity);
+        }
+        (*names)[count++] = strdup(entry->d_name);
+    }
+    closedir(dir);
+
+    qsort(*names, count, sizeof(char *), compareNames);
+    return count;
+}
+
+// Loads every maze file in the maze folder, in alphabetical order, skipping (and reporting) malformed files
+// names receives the file name of each maze loaded; free both arrays and each maze and name when done
+// Returns the number of mazes loaded, or -1 if the folder could not be read
+int loadMazes(Maze **mazes, char ***names)
+{
+    int count = listMazes(names);
+    if(count <= 0) return count;
+
+    *mazes = calloc(count, sizeof(Maze));
+    if(!*mazes) return -1;
+
+    int messages = mazeMessages;
+    mazeMessages = 0;
+    int loaded = 0;
+    for(int i = 0; i < count; i++)
+    {
+        if(loadMaze(&(*mazes)[loaded], (*names)[i])) (*names)[loaded++] = (*names)[i];
+        else free((*names)[i]);
+    }
+    // A failed load leaves its storage in the next free slot
+    if(loaded < count) freeMaze(&(*mazes)[loaded]);
+    mazeMessages = messages;
+
+    return loaded;
 }
 
+#ifndef HEADLESS
 // Generate maze texture from wall arrays
 SDL_Texture* createMazeTexture(Maze *maze)
 {
@@ -135,7 +603,7 @@ SDL_Texture* createMazeTexture(Maze *maze)
         {x_0, y_0 + (CELL_LENGTH * maze->size), (CELL_LENGTH * maze->size) + WALL_THICKNESS, WALL_THICKNESS}
     };
 
-    // Render vertical walls
+    // Render vertical walls (east side of every cell except the last column); screen row 0 is maze row size - 1
     int x = x_0 + CELL_LENGTH;
     int y = y_0;
     for(int i = 0; i < maze->size; i++)
@@ -144,7 +612,7 @@ SDL_Texture* createMazeTexture(Maze *maze)
 
         for(int j = 0; j < maze->size - 1; j++)
         {
-            if(maze->vWalls[i][j])
+            if(hasWall(maze, j, maze->size - 1 - i, EAST))
             {
                 SDL_Rect tempRect = {x, y, WALL_THICKNESS, CELL_LENGTH + WALL_THICKNESS};
                 SDL_FillRect(mazeSurface, &tempRect, wallColor);
@@ -156,7 +624,7 @@ SDL_Texture* createMazeTexture(Maze *maze)
         y += CELL_LENGTH;
     }
 
-    // Render horizontal walls
+    // Render horizontal walls (south side of every cell except the bottom row)
     x = x_0;
     y = y_0 + CELL_LENGTH;
     for(int i = 0; i < maze->size - 1; i++)
@@ -165,7 +633,7 @@ SDL_Texture* createMazeTexture(Maze *maze)
 
         for(int j = 0; j < maze->size; j++)
         {
-            if(maze->hWalls[i][j])
+            if(hasWall(maze, j, maze->size - 1 - i, SOUTH))
             {
                 SDL_Rect tempRect = {x, y, CELL_LENGTH + WALL_THICKNESS, WALL_THICKNESS};
                 SDL_FillRect(mazeSurface, &tempRect, wallColor);
@@ -191,3 +659,4 @@ int renderMaze(Maze *maze)
     SDL_RenderCopy(renderer, maze->mazeTexture, NULL, NULL);
     return 1;
 }
+#endif
@@ -1,19 +1,77 @@
 #ifndef MAZE_H
 #define MAZE_H
 
+#ifndef HEADLESS
 #include <SDL2/SDL.h>
+#endif
+#include <stddef.h>
+#include <stdint.h>
+
+// Wall bits of a cell's 4-bit wall mask; bit order matches Heading so a mask can be rotated by heading
+#define WALL_NORTH 1
+#define WALL_EAST 2
+#define WALL_SOUTH 4
+#define WALL_WEST 8
 
+// Walls are stored packed: a 4-bit mask per cell (two cells per byte) indexed by y * size + x with y = 0 at the
+// bottom row, plus per-row bitsets of north and east walls where bit x of row y describes cell (x, y)
+// Storage is heap-allocated to fit the maze size; each bitset row takes rowWords 64-bit words
+// rays caches how far each cell can see in each direction for long-range sensor queries; it is rebuilt by
+// updateRays when a maze is loaded and marked stale whenever a wall changes
 typedef struct
 {
     char name[64];
     int size;
+#ifndef HEADLESS
     SDL_Texture* mazeTexture;
-    int hWalls [17][16];
-    int vWalls [16][17];
+#endif
+    int rowWords;
+    uint8_t *walls;
+    uint64_t *northWalls;
+    uint64_t *eastWalls;
+    uint16_t *rays;         // Cells to the nearest wall, index (y * size + x) * 4 + direction
+    int raysValid;          // 1 if rays matches the walls
 } Maze;
 
+extern int mazeMessages;
+
 int loadMaze(Maze* maze, const char *path);
+int saveMaze(Maze *maze, const char *path);
+int clearMaze(Maze *maze, int size);
+size_t getMazeStorageSize(int size);
+void initMazeIn(Maze *maze, int size, void *storage);
+void freeMaze(Maze *maze);
+void setWall(Maze *maze, int x, int y, int direction, int present);
+void updateCellWalls(Maze *maze);
+int updateRays(Maze *maze);
+int traceWallDistance(const Maze *maze, int x, int y, int direction);
+int isGoal(Maze *maze, int x, int y);
+int listMazes(char ***names);
+int loadMazes(Maze **mazes, char ***names);
+#ifndef HEADLESS
 SDL_Texture* createMazeTexture(Maze *maze);
 int renderMaze(Maze *maze);
+#endif
+
+// Returns the 4-bit wall mask (WALL_NORTH | WALL_EAST | ...) of cell (x, y)
+static inline int getWalls(const Maze *maze, int x, int y)
+{
+    int i = y * maze->size + x;
+    return (maze->walls[i >> 1] >> ((i & 1) << 2)) & 0xF;
+}
+
+// Returns 1 if cell (x, y) has a wall in the given direction (NORTH, EAST, SOUTH or WEST), 0 otherwise
+static inline int hasWall(const Maze *maze, int x, int y, int direction)
+{
+    return (getWalls(maze, x, y) >> direction) & 1;
+}
+
+// Returns the number of cells between cell (x, y) and the nearest wall in the given direction (0 if the cell
+// has a wall on that side); a table lookup unless walls have changed since the rays were last built
+static inline int getWallDistance(const Maze *maze, int x, int y, int direction)
+{
+    if(maze->raysValid) return maze->rays[(y * maze->size + x) * 4 + direction];
+    return traceWallDistance(maze, x, y, direction);
+}
 
 #endif
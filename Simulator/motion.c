@@ -0,0 +1,181 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "motion.h"
+
+// An unhurried exploring pace on 18 cm cells
+const MotionProfile defaultMotionProfile = {0.18, 1.0, 3.0, 3.0, 720, 7200, 0.001};
+
+static const int dx[4] = {0, 1, 0, -1};
+static const int dy[4] = {1, 0, -1, 0};
+
+// Reads settings given as a comma separated list of name=value pairs (cell, speed, accel, decel, turnrate,
+// turnaccel, step) into profile; settings left out keep their values
+// Returns 1 if successful, 0 otherwise
+int parseMotionProfile(const char *text, MotionProfile *profile)
+{
+    MotionProfile result = *profile;
+    const char *names[] = {"cell", "speed", "accel", "decel", "turnrate", "turnaccel", "step"};
+    double *values[] = {&result.cellLength, &result.maxSpeed, &result.acceleration, &result.deceleration,
+                        &result.maxTurnRate, &result.turnAcceleration, &result.timeStep};
+
+    while(*text)
+    {
+        char name[16];
+        double value;
+        int length;
+        if(sscanf(text, "%15[^=,]=%lf%n", name, &value, &length) != 2 || !(value > 0))
+        {
+            printf("Error: motion settings must be name=value pairs with positive values, got %s\n", text);
+            return 0;
+        }
+
+        int i = 0;
+        while(i < 7 && strcmp(names[i], name)) i++;
+        if(i == 7)
+        {
+            printf("Error: unknown motion setting %s (expected cell, speed, accel, decel, turnrate, turnaccel "
+                   "or step)\n", name);
+            return 0;
+        }
+        *values[i] = value;
+
+        text += length;
+        if(*text == ',') text++;
+    }
+
+    *profile = result;
+    return 1;
+}
+
+// Sets up a mouse body with the given profile, at rest in cell (0, 0) facing north
+void initMotion(MotionState *motion, const MotionProfile *profile)
+{
+    *motion = (MotionState) {0};
+    motion->profile = *profile;
+}
+
+// Puts the mouse at rest in cell (x, y) facing the given heading and restarts the clock
+void placeMotion(MotionState *motion, int x, int y, Heading heading)
+{
+    MotionProfile profile = motion->profile;
+    *motion = (MotionState) {0};
+    motion->profile = profile;
+    motion->x = x;
+    motion->y = y;
+    motion->heading = heading;
+}
+
+// Returns 1 if the mouse is stopped with nothing left to do, 0 otherwise
+int isAtRest(const MotionState *motion)
+{
+    return !motion->cells && !motion->turn && motion->wait <= 0;
+}
+
+// Returns 1 if the solver has to decide the next action before the next step, 0 otherwise
+// That is when the mouse is at rest, or when one more step at full acceleration would leave it unable to brake
+// to a stop within the cells committed so far
+int needsAction(const MotionState *motion)
+{
+    if(motion->turn || motion->wait > 0) return 0;
+    if(!motion->cells) return 1;
+
+    const MotionProfile *p = &motion->profile;
+    double speed = motion->speed + p->acceleration * p->timeStep;
+    if(speed > p->maxSpeed) speed = p->maxSpeed;
+    double remaining = motion->cells * p->cellLength - motion->offset - speed * p->timeStep;
+    return remaining < speed * speed / (2 * p->deceleration);
+}
+
+// Commits the mouse to the solver's next action: forward moves extend the straight being driven, turns and
+// idles wait for the mouse to stop at the end of it
+void commitAction(MotionState *motion, Action action)
+{
+    switch(action)
+    {
+        case FORWARD:
+            motion->cells++;
+            break;
+
+        case LEFT:
+            motion->turn = -90;
+            break;
+
+        case RIGHT:
+            motion->turn = 90;
+            break;
+
+        // Idling takes as long as crossing a cell at top speed
+        case IDLE:
+            motion->wait = motion->profile.cellLength / motion->profile.maxSpeed;
+            break;
+    }
+}
+
+// Advances the mouse by one time step: accelerating towards top speed while it can still stop in time,
+// braking otherwise, and then turning or idling in place
+// Returns 1 if the mouse reached a cell center or finished a turn or idle in this step, 0 otherwise
+int stepMotion(MotionState *motion)
+{
+    if(isAtRest(motion)) return 0;
+
+    const MotionProfile *p = &motion->profile;
+    double dt = p->timeStep;
+    motion->time += dt;
+
+    if(motion->cells)
+    {
+        double remaining = motion->cells * p->cellLength - motion->offset;
+        double speed = motion->speed + p->acceleration * dt;
+        if(speed > p->maxSpeed) speed = p->maxSpeed;
+        double stopping = sqrt(2 * p->deceleration * remaining);
+        if(speed > stopping) speed = stopping;
+        motion->speed = speed;
+        motion->offset += speed * dt;
+
+        int passed = 0;
+        while(motion->cells && motion->offset >= p->cellLength - 1e-9)
+        {
+            motion->offset -= p->cellLength;
+            motion->cells--;
+            motion->x += dx[motion->heading];
+            motion->y += dy[motion->heading];
+            passed = 1;
+        }
+        if(!motion->cells) motion->offset = motion->speed = 0;
+
+        return passed;
+    }
+
+    if(motion->turn)
+    {
+        double remaining = abs(motion->turn) - motion->angle;
+        double rate = motion->turnRate + p->turnAcceleration * dt;
+        if(rate > p->maxTurnRate) rate = p->maxTurnRate;
+        double stopping = sqrt(2 * p->turnAcceleration * remaining);
+        if(rate > stopping) rate = stopping;
+        motion->turnRate = rate;
+        motion->angle += rate * dt;
+        if(motion->angle < abs(motion->turn) - 1e-9) return 0;
+
+        motion->heading = (motion->heading + (motion->turn > 0 ? 1 : 3)) % 4;
+        motion->turn = 0;
+        motion->angle = motion->turnRate = 0;
+        return 1;
+    }
+
+    motion->wait -= dt;
+    if(motion->wait > 1e-12) return 0;
+    motion->wait = 0;
+    return 1;
+}
+
+// Gets the mouse's current position (cells) and angle (degrees clockwise from north)
+void getMotionPose(const MotionState *motion, double *x, double *y, double *angle)
+{
+    double part = motion->offset / motion->profile.cellLength;
+    *x = motion->x + dx[motion->heading] * part;
+    *y = motion->y + dy[motion->heading] * part;
+    *angle = 90 * motion->heading + (motion->turn < 0 ? -motion->angle : motion->angle);
+}
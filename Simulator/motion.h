@@ -0,0 +1,48 @@
+#ifndef MOTION_H
+#define MOTION_H
+
+#include "mouse.h"
+
+// Physical limits of the mouse; straights and turns in place both follow trapezoidal speed profiles
+typedef struct
+{
+    double cellLength;              // Length of one cell (m)
+    double maxSpeed;                // Top speed on straights (m/s)
+    double acceleration;            // Speeding up on straights (m/s^2)
+    double deceleration;            // Braking on straights (m/s^2)
+    double maxTurnRate;             // Top turning speed (degrees/s)
+    double turnAcceleration;        // Angular acceleration and braking (degrees/s^2)
+    double timeStep;                // Integration step (s)
+} MotionProfile;
+
+extern const MotionProfile defaultMotionProfile;
+
+// Physical state of the mouse, integrated at the profile's fixed time step
+// Solver decisions run ahead of the body: forward moves are committed as the mouse needs to know whether to
+// brake, so the mouse drives through cells the solver has already left and only stops where it has to turn
+// or idle. A turn or idle is queued behind the committed cells and runs once the mouse has stopped
+typedef struct MotionState
+{
+    MotionProfile profile;
+    int x, y;                       // Last cell center the mouse passed or stopped at
+    int heading;                    // Heading it is driving or last stopped in
+    int cells;                      // Cells committed ahead of (x, y)
+    double offset;                  // Distance driven past (x, y) (m)
+    double speed;                   // Forward speed (m/s)
+    int turn;                       // Queued or running turn: -90 for left, 90 for right, 0 for none
+    double angle;                   // Part of the turn done so far (degrees)
+    double turnRate;                // Turning speed (degrees/s)
+    double wait;                    // Queued or running idle time left (s)
+    double time;                    // Simulated time since the mouse was placed (s)
+} MotionState;
+
+int parseMotionProfile(const char *text, MotionProfile *profile);
+void initMotion(MotionState *motion, const MotionProfile *profile);
+void placeMotion(MotionState *motion, int x, int y, Heading heading);
+int needsAction(const MotionState *motion);
+void commitAction(MotionState *motion, Action action);
+int stepMotion(MotionState *motion);
+int isAtRest(const MotionState *motion);
+void getMotionPose(const MotionState *motion, double *x, double *y, double *angle);
+
+#endif
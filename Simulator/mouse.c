@@ -1,51 +1,92 @@
+#ifndef HEADLESS
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_image.h>
+#endif
 #include <stdio.h>
 #include <stdlib.h>
 #include "mouse.h"
 #include "maze.h"
 #include <math.h>
 #include "solver.h"
+#include "motion.h"
+#ifndef HEADLESS
+#include "timing.h"
+#endif
 
 
+#ifndef HEADLESS
 extern int SCREEN_WIDTH, SCREEN_HEIGHT, MAZE_PADDING, WALL_THICKNESS, MAX_MAZE_SIZE, MIN_MAZE_SIZE, MIN_SCREEN_DIMENSION, MAX_SCREEN_DIMENSION, MAZE_WIDTH, CELL_LENGTH, x_0, y_0;
-extern float MOUSE_SIZE, xCorrection, yCorrection;
-extern int MOVE_STEP, TURN_STEP;
+extern float MOUSE_SIZE;
 extern SDL_Renderer* renderer;
-extern Maze maze;
 extern int running;
 
-// Store goal and initial position and angle offsets; used for rendering
-int goalDx = 0, goalDy = 0, goalDa = 0, xi = 0, yi = 0, ai = 0;
+#define TRAIL_ALPHA 160             // Opacity of the newest part of a trail; older parts fade out
+#define TRAIL_WIDTH 0.1             // Width of a trail (percentage of cell size)
 
-int loadMouse(Mouse* mouse)
+// Vertices and indices for drawing the mice, grown as needed; every quad uses the same six indices, so they
+// are filled in once when the buffers grow
+static SDL_Vertex *vertices = NULL;
+static int *indices = NULL;
+static int quadCapacity = 0;
+
+static void pushTrail(Mouse *mouse, int x, int y);
+#endif
+
+// Place mouse in the bottom left corner of the given maze, facing north
+// The mouse's solver and solver state are left untouched
+void initMouse(Mouse* mouse, Maze* maze)
 {
-    // Initialize mouse position and heading
-    mouse->x = 0;
-    mouse->y = 0;
-    mouse->absX = 0;
-    mouse->absY = 0;
-    mouse->absA = 0;
-    mouse->heading = NORTH;
+    mouse->maze = maze;
+    placeMouse(mouse, 0, 0, NORTH);
+}
+
+// Moves mouse to cell (x, y) facing the given heading and stops its body there, clearing any move in progress
+void placeMouse(Mouse* mouse, int x, int y, Heading heading)
+{
+    mouse->x = x;
+    mouse->y = y;
+    mouse->heading = heading;
     mouse->action = IDLE;
-    mouse->maze = &maze;
+    if(mouse->motion) placeMotion(mouse->motion, x, y, heading);
+#ifndef HEADLESS
+    mouse->fromX = mouse->drawX = x;
+    mouse->fromY = mouse->drawY = y;
+    mouse->fromA = mouse->drawA = 90 * heading;
+    mouse->trailCount = 0;
+    mouse->trailNext = 0;
+    pushTrail(mouse, x, y);
+#endif
+}
+
+#ifndef HEADLESS
+int loadMouse(Mouse* mouse, Maze* maze)
+{
+    // Initialize mouse position and heading
+    initMouse(mouse, maze);
 
-    // Load mouse image
-    SDL_Surface* tempSurface = IMG_Load("./mouse.png");
-    if(tempSurface == NULL)
+    // Load mouse image; all mice share one texture so they can be drawn together
+    static SDL_Texture* texture = NULL;
+    if(texture == NULL)
     {
-        printf( "Error: Unable to load image %s! SDL_image Error: %s\n", "./mouse.png", IMG_GetError() );
-        exit(-1);
+        SDL_Surface* tempSurface = IMG_Load("./mouse.png");
+        if(tempSurface == NULL)
+        {
+            printf( "Error: Unable to load image %s! SDL_image Error: %s\n", "./mouse.png", IMG_GetError() );
+            exit(-1);
+        }
+
+        texture = SDL_CreateTextureFromSurface(renderer, tempSurface);
+        SDL_FreeSurface(tempSurface);
     }
-
-    mouse->mouseTexture = SDL_CreateTextureFromSurface(renderer, tempSurface);
-    SDL_FreeSurface(tempSurface);
+    mouse->mouseTexture = texture;
+    if(!mouse->color.a) mouse->color = (SDL_Color) {255, 255, 255, 255};
 
     // Initialize mouseRect and mouseCenter
     updateRect(mouse);
 
     return 1;
 }
+#endif
 
 
 // Returns direction mouse is facing
@@ -54,95 +95,43 @@ Heading getHeading(Mouse* mouse)
     return mouse->heading;
 }
 
-// Gets next mouse action from solver algorithm and then performs the action
-Action getNextAction(Mouse* mouse)
+// Updates mouse position and heading for a single action
+// Return 1 if the action was performed, 0 if the mouse attempted to move through a wall
+int performAction(Mouse* mouse, Action action)
 {
-    Action action = solver(mouse);
     mouse->action = action;
 
-    // Handles each action
     switch(action)
     {
-        // Update position and goal movement depending on heading
         case FORWARD:
-            if(getFrontReading(mouse))
-            {
-                printf("Error: mouse attempted to move through wall\nPress s to resume\n");
-                running = 0;
-                return IDLE;
-            }
-            else
-            {
-                switch(getHeading(mouse))
-                {
-                    case NORTH:
-                        mouse->y++;
-                        goalDy = CELL_LENGTH / yCorrection;
-                        break;
-
-                    case EAST:
-                        mouse->x++;
-                        goalDx = CELL_LENGTH / xCorrection;
-                        break;
-
-                    case SOUTH:
-                        mouse->y--;
-                        goalDy = -CELL_LENGTH / yCorrection;
-                        break;
-
-                    case WEST:
-                        mouse->x--;
-                        goalDx = -CELL_LENGTH / xCorrection;
-                        break;
-                }
-                break;
-            }
+            if(getFrontReading(mouse)) return 0;
 
-        // Update heading and set goal rotation amount
-        case LEFT:
-            switch(mouse->heading)
+            switch(getHeading(mouse))
             {
                 case NORTH:
-                    mouse->heading = WEST;
+                    mouse->y++;
                     break;
 
                 case EAST:
-                    mouse->heading = NORTH;
+                    mouse->x++;
                     break;
 
                 case SOUTH:
-                    mouse->heading = EAST;
+                    mouse->y--;
                     break;
 
                 case WEST:
-                    mouse->heading = SOUTH;
+                    mouse->x--;
                     break;
             }
+            break;
 
-            goalDa = -90;
+        case LEFT:
+            mouse->heading = (mouse->heading + 3) % 4;
             break;
 
-        // Update heading and set goal rotation amount
         case RIGHT:
-            switch(mouse->heading)
-            {
-                case NORTH:
-                    mouse->heading = EAST;
-                    break;
-
-                case EAST:
-                    mouse->heading = SOUTH;
-                    break;
-
-                case SOUTH:
-                    mouse->heading = WEST;
-                    break;
-
-                case WEST:
-                    mouse->heading = NORTH;
-                    break;
-            }
-            goalDa = 90;
+            mouse->heading = (mouse->heading + 1) % 4;
             break;
 
         // Do nothing
@@ -150,182 +139,274 @@ Action getNextAction(Mouse* mouse)
             break;
     }
 
-    return action;
+    return 1;
 }
 
-
-// Handles rendering of mouse moves and turns
-// Return 0 if rendering of a movement is finished or if mouse is idling
-// Return 1 if a movement is currently being rendered
-int renderMouse(Mouse *mouse)
+#ifndef HEADLESS
+// Gets next mouse action from solver algorithm, performs it and commits the mouse's body to it
+Action getNextAction(Mouse* mouse)
 {
-    // Renders mouse to screen
-    SDL_RenderCopyEx(renderer, mouse->mouseTexture, NULL, &(mouse->mouseRect), mouse->absA, &(mouse->mouseCenter), SDL_FLIP_NONE);
+    uint64_t start = startTiming();
+    Action action = solver(mouse);
+    endTiming(STAGE_SOLVER, start);
 
-    // Update mouse texture bounding box
-    updateRect(mouse);
+    if(!performAction(mouse, action))
+    {
+        printf("Error: mouse attempted to move through wall\nPress s to resume\n");
+        mouse->action = action = IDLE;
+        running = 0;
+    }
 
-    if(!running) return IDLE;
+    commitAction(mouse->motion, action);
+    return action;
+}
 
-    // dx, dy, and da store offset amounts
-    int dx = 0, dy = 0, da = 0;
+// Advances the mouse's body by one simulation tick, asking the solver for actions whenever the body needs to
+// know what comes next
+// Returns 1 if the mouse reached a cell center or finished a turn or idle in this tick, 0 otherwise
+int stepMouse(Mouse *mouse)
+{
+    double x, y, a;
+    getMotionPose(mouse->motion, &x, &y, &a);
+    mouse->fromX = x;
+    mouse->fromY = y;
+    mouse->fromA = a;
+
+    while(needsAction(mouse->motion)) getNextAction(mouse);
+    int done = stepMotion(mouse->motion);
+    pushTrail(mouse, mouse->motion->x, mouse->motion->y);
+    return done;
+}
 
-    // Set offsets depending on action and current heading
-    switch(mouse->action)
-    {
-        case FORWARD:
-            switch(mouse->heading)
-            {
-                case NORTH:
-                    dy = MOVE_STEP;
-                    break;
+// Adds a cell center to the mouse's trail unless it is the one the trail already ends at
+static void pushTrail(Mouse *mouse, int x, int y)
+{
+    int last = (mouse->trailNext + TRAIL_LENGTH - 1) % TRAIL_LENGTH;
+    if(mouse->trailCount && mouse->trailX[last] == x && mouse->trailY[last] == y) return;
 
-                case EAST:
-                    dx = MOVE_STEP;
-                    break;
+    mouse->trailX[mouse->trailNext] = x;
+    mouse->trailY[mouse->trailNext] = y;
+    mouse->trailNext = (mouse->trailNext + 1) % TRAIL_LENGTH;
+    if(mouse->trailCount < TRAIL_LENGTH) mouse->trailCount++;
+}
 
-                case SOUTH:
-                    dy = -MOVE_STEP;
-                    break;
+// Sets the pose the mouse is drawn in to where its body is part way through the current simulation tick
+// fraction is the part of the tick that has passed, from 0 to 1
+void updateMousePose(Mouse *mouse, float fraction)
+{
+    double x, y, a;
+    getMotionPose(mouse->motion, &x, &y, &a);
+    if(fraction > 1) fraction = 1;
+
+    // Headings wrap around at north, so interpolate the angle the short way round
+    float fromA = mouse->fromA;
+    if(a - fromA > 180) fromA += 360;
+    else if(fromA - a > 180) fromA -= 360;
+
+    mouse->drawX = mouse->fromX + (x - mouse->fromX) * fraction;
+    mouse->drawY = mouse->fromY + (y - mouse->fromY) * fraction;
+    mouse->drawA = fromA + (a - fromA) * fraction;
+    updateRect(mouse);
+}
 
-                case WEST:
-                    dx = -MOVE_STEP;
-                    break;
-            }
-            break;
+// Renders mouse to screen in its current pose
+void renderMouse(Mouse *mouse)
+{
+    SDL_RenderCopyEx(renderer, mouse->mouseTexture, NULL, &(mouse->mouseRect), mouse->drawA, &(mouse->mouseCenter), SDL_FLIP_NONE);
+}
 
-        case LEFT:
-            da = -TURN_STEP;
-            break;
+// Makes room in the vertex and index buffers for the given number of quads
+// Returns 1 on success, 0 if memory could not be allocated
+static int reserveQuads(int quads)
+{
+    if(quads <= quadCapacity) return 1;
+
+    int capacity = quadCapacity ? quadCapacity : 256;
+    while(capacity < quads) capacity *= 2;
+    SDL_Vertex *newVertices = realloc(vertices, sizeof(SDL_Vertex) * 4 * capacity);
+    if(!newVertices) return 0;
+    vertices = newVertices;
+    int *newIndices = realloc(indices, sizeof(int) * 6 * capacity);
+    if(!newIndices) return 0;
+    indices = newIndices;
+
+    for(int q = quadCapacity; q < capacity; q++)
+    {
+        int *i = &indices[6*q];
+        i[0] = 4*q; i[1] = 4*q + 1; i[2] = 4*q + 2;
+        i[3] = 4*q; i[4] = 4*q + 2; i[5] = 4*q + 3;
+    }
+    quadCapacity = capacity;
+    return 1;
+}
 
-        case RIGHT:
-            da = TURN_STEP;
-            break;
+// Returns the screen position of a point given in cells, where whole numbers are cell centers
+static SDL_FPoint cellToScreen(Mouse *mouse, float x, float y)
+{
+    SDL_FPoint point = {x_0 + (x + 0.5f) * CELL_LENGTH, y_0 + (mouse->maze->size - 0.5f - y) * CELL_LENGTH};
+    return point;
+}
 
-        case IDLE:
-            break;
+// Writes a quad covering a line from a to b of the given width, extended by half the width at both ends so
+// the corners of a trail are filled
+// Returns the number of quads written: 0 if a and b are the same point, otherwise 1
+static int writeLineQuad(SDL_Vertex *v, SDL_FPoint a, SDL_FPoint b, float width, SDL_Color color)
+{
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float length = sqrtf(dx*dx + dy*dy);
+    if(length == 0) return 0;
+
+    // Half-width steps along the line and across it
+    float ax = dx / length * width / 2, ay = dy / length * width / 2;
+    SDL_FPoint corners[4] = {{a.x - ax + ay, a.y - ay - ax}, {b.x + ax + ay, b.y + ay - ax},
+                             {b.x + ax - ay, b.y + ay + ax}, {a.x - ax - ay, a.y - ay + ax}};
+    for(int i = 0; i < 4; i++) v[i] = (SDL_Vertex) {corners[i], color, {0, 0}};
+    return 1;
+}
+
+// Renders every mouse and its trail in its current pose, all trails in one batch of geometry and all bodies in
+// another, so hundreds of mice cost about as much to draw as one. Bodies are tinted with their mouse's color
+// If the renderer cannot draw geometry, bodies are drawn one by one and trails are left out
+void renderMice(Mouse *mice, int count)
+{
+    if(count < 1) return;
+    if(!reserveQuads(count * TRAIL_LENGTH))
+    {
+        for(int i = 0; i < count; i++) renderMouse(&mice[i]);
+        return;
     }
 
-    // If movement not complete, add offsets to current position
-    if((goalDx < 0 && xi > goalDx) || (goalDx > 0 && xi < goalDx) || 
-       (goalDy < 0 && yi > goalDy) || (goalDy > 0 && yi < goalDy) ||
-       (goalDa < 0 && ai > goalDa) || (goalDa > 0 && ai < goalDa))
+    // Trails: a line through the last cell centers passed, fading out with age, up to the body's position
+    int quads = 0;
+    float width = CELL_LENGTH * TRAIL_WIDTH;
+    if(width < 1) width = 1;
+    for(int i = 0; i < count; i++)
     {
-        int correction = xCorrection*yCorrection;
-        xi += dx * correction;
-        yi += dy * correction;
-        ai += da * correction;
+        Mouse *mouse = &mice[i];
+        int first = (mouse->trailNext + TRAIL_LENGTH - mouse->trailCount) % TRAIL_LENGTH;
+        for(int k = 0; k < mouse->trailCount; k++)
+        {
+            int from = (first + k) % TRAIL_LENGTH, to = (from + 1) % TRAIL_LENGTH;
+            SDL_FPoint a = cellToScreen(mouse, mouse->trailX[from], mouse->trailY[from]);
+            SDL_FPoint b = k + 1 < mouse->trailCount ? cellToScreen(mouse, mouse->trailX[to], mouse->trailY[to]) :
+                                                       cellToScreen(mouse, mouse->drawX, mouse->drawY);
+            SDL_Color color = mouse->color;
+            color.a = TRAIL_ALPHA * (k + 1) / mouse->trailCount;
+            quads += writeLineQuad(&vertices[4*quads], a, b, width, color);
+        }
+    }
 
-        mouse->absX += dx * correction;
-        mouse->absY += dy * correction;
-        mouse->absA += da * correction;
+    SDL_BlendMode blendMode;
+    SDL_GetRenderDrawBlendMode(renderer, &blendMode);
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    int drawn = !quads || !SDL_RenderGeometry(renderer, NULL, vertices, 4*quads, indices, 6*quads);
+    SDL_SetRenderDrawBlendMode(renderer, blendMode);
 
-        return 1;
-    }
-    else
+    // Bodies: the texture rotated about mouseCenter, as SDL_RenderCopyEx would draw it, tinted halfway to the
+    // mouse's color so the picture stays visible
+    const SDL_FPoint texCoords[4] = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
+    for(int i = 0; i < count; i++)
     {
-        // Snap mouse to grid (in case it moved an uneven amount)
-        mouse->absX = CELL_LENGTH * mouse->x / xCorrection;
-        mouse->absY = CELL_LENGTH * mouse->y / yCorrection;
-        mouse->absA = round(mouse->absA / 90) * 90;
-
-        // Reset goal offsets and initial offsets
-        goalDx = goalDy = goalDa = xi = yi = ai = 0;
+        Mouse *mouse = &mice[i];
+        SDL_Rect rect = mouse->mouseRect;
+        float pivotX = rect.x + mouse->mouseCenter.x, pivotY = rect.y + mouse->mouseCenter.y;
+        float angle = mouse->drawA * M_PI / 180, c = cosf(angle), s = sinf(angle);
+        SDL_Color tint = {(255 + mouse->color.r) / 2, (255 + mouse->color.g) / 2, (255 + mouse->color.b) / 2, 255};
+
+        SDL_Vertex *v = &vertices[4*i];
+        for(int k = 0; k < 4; k++)
+        {
+            float dx = texCoords[k].x * rect.w - mouse->mouseCenter.x;
+            float dy = texCoords[k].y * rect.h - mouse->mouseCenter.y;
+            v[k] = (SDL_Vertex) {{pivotX + dx*c - dy*s, pivotY + dx*s + dy*c}, tint, texCoords[k]};
+        }
+    }
+    if(drawn && !SDL_RenderGeometry(renderer, mice[0].mouseTexture, vertices, 4*count, indices, 6*count)) return;
+    for(int i = 0; i < count; i++) renderMouse(&mice[i]);
+}
 
-        return 0;
+// Returns the screen area the mouse texture and its trail may cover at its current position, whatever its angle
+SDL_Rect getMouseBounds(Mouse *mouse)
+{
+    // The texture rotates about mouseCenter, so it stays inside the circle through its farthest corner; one
+    // extra pixel covers the edge pixels touched by filtering
+    SDL_Rect rect = mouse->mouseRect;
+    SDL_Point center = mouse->mouseCenter;
+    int dx = center.x > rect.w - center.x ? center.x : rect.w - center.x;
+    int dy = center.y > rect.h - center.y ? center.y : rect.h - center.y;
+    int radius = ceil(sqrt(dx*dx + dy*dy)) + 1;
+
+    SDL_Rect bounds = {rect.x + center.x - radius, rect.y + center.y - radius, 2*radius, 2*radius};
+
+    // The trail runs between cell centers, and its quads reach past them by half the trail's width; its cells are
+    // the last trailCount entries of the ring, ending just before trailNext
+    int first = (mouse->trailNext + TRAIL_LENGTH - mouse->trailCount) % TRAIL_LENGTH;
+    for(int k = 0; k < mouse->trailCount; k++)
+    {
+        int from = (first + k) % TRAIL_LENGTH;
+        SDL_FPoint point = cellToScreen(mouse, mouse->trailX[from], mouse->trailY[from]);
+        int margin = CELL_LENGTH * TRAIL_WIDTH / 2 + 2;
+        SDL_Rect cell = {point.x - margin, point.y - margin, 2*margin, 2*margin};
+        SDL_UnionRect(&bounds, &cell, &bounds);
     }
+    return bounds;
 }
 
 // Updates mouse texture bounding box
 void updateRect(Mouse *mouse)
 {
     int padding = CELL_LENGTH - 2*WALL_THICKNESS - (CELL_LENGTH - 2*WALL_THICKNESS) * MOUSE_SIZE;
-    mouse->mouseRect.x = x_0 + WALL_THICKNESS + padding + mouse->absX * xCorrection;
-    mouse->mouseRect.y = y_0 + MAZE_WIDTH - CELL_LENGTH - WALL_THICKNESS + padding - mouse->absY * yCorrection;
+    mouse->mouseRect.x = x_0 + WALL_THICKNESS + padding + mouse->drawX * CELL_LENGTH;
+    mouse->mouseRect.y = y_0 + CELL_LENGTH * (mouse->maze->size - 1 - mouse->drawY) + WALL_THICKNESS + padding;
     mouse->mouseRect.w = CELL_LENGTH - 2*WALL_THICKNESS - 2*padding;
     mouse->mouseRect.h = CELL_LENGTH - 2*WALL_THICKNESS - 2*padding;
 
     mouse->mouseCenter.x = mouse->mouseRect.w/2;
     mouse->mouseCenter.y = mouse->mouseRect.h * 0.711;
 }
+#endif
+
+// Returns the walls around the mouse relative to its heading by rotating the cell's wall mask
+// Bit 0: front, bit 1: right, bit 2: back, bit 3: left
+static inline int getRelativeWalls(Mouse *mouse)
+{
+    int walls = getWalls(mouse->maze, mouse->x, mouse->y);
+    return ((walls | (walls << 4)) >> mouse->heading) & 0xF;
+}
 
 // Returns 1 if there is a wall to the mouse's left, 0 otherwise
 int getLeftReading(Mouse *mouse)
 {
-    Heading heading = mouse->heading;
-    Maze* maze = mouse->maze;
-    int size = maze->size - 1;
-
-    switch(heading)
-    {
-        case NORTH:
-            return (mouse->x == 0) ? 1 : maze->vWalls[size - mouse->y][mouse->x - 1];
-            break;
-
-        case EAST:
-            return (mouse->y == size) ? 1 : maze->hWalls[size - 1 - mouse->y][mouse->x];
-            break;
-
-        case SOUTH:
-            return (mouse->x == size) ? 1 : maze->vWalls[size - mouse->y][mouse->x];
-            break;
-
-        case WEST:
-            return (mouse->y == 0) ? 1 : maze->hWalls[size - mouse->y][mouse->x];
-            break;
-    }
+    return (getRelativeWalls(mouse) >> 3) & 1;
 }
 
 // Returns 1 if there is a wall in front of the mouse, 0 otherwise
 int getFrontReading(Mouse *mouse)
 {
-    Heading heading = mouse->heading;
-    Maze* maze = mouse->maze;
-    int size = maze->size - 1;
-
-    switch(heading)
-    {
-        case NORTH:
-            return (mouse->y == size) ? 1 : maze->hWalls[size - 1 - mouse->y][mouse->x];
-            break;
-
-        case EAST:
-            return (mouse->x == size) ? 1 : maze->vWalls[size - mouse->y][mouse->x];
-            break;
-
-        case SOUTH:
-            return (mouse->y == 0) ? 1 : maze->hWalls[size - mouse->y][mouse->x];
-            break;
-
-        case WEST:
-            return (mouse->x == 0) ? 1 : maze->vWalls[size - mouse->y][mouse->x - 1];
-            break;
-    }
+    return getRelativeWalls(mouse) & 1;
 }
 
 // Returns 1 if there is a wall to the mouse's right, 0 otherwise
 int getRightReading(Mouse *mouse)
 {
-    Heading heading = mouse->heading;
-    Maze* maze = mouse->maze;
-    int size = maze->size - 1;
-
-    switch(heading)
-    {
-        case NORTH:
-            return (mouse->x == size) ? 1 : maze->vWalls[size - mouse->y][mouse->x];
-            break;
+    return (getRelativeWalls(mouse) >> 1) & 1;
+}
 
-        case EAST:
-            return (mouse->y == 0) ? 1 : maze->hWalls[size - mouse->y][mouse->x];
-            break;
+// Returns the number of open cells the mouse's left sensor sees before the nearest wall (0 if there is a wall
+// directly to the left)
+int getLeftDistance(Mouse *mouse)
+{
+    return getWallDistance(mouse->maze, mouse->x, mouse->y, (mouse->heading + 3) % 4);
+}
 
-        case SOUTH:
-            return (mouse->x == 0) ? 1 : maze->vWalls[size - mouse->y][mouse->x - 1];
-            break;
+// Returns the number of open cells the mouse's front sensor sees before the nearest wall
+int getFrontDistance(Mouse *mouse)
+{
+    return getWallDistance(mouse->maze, mouse->x, mouse->y, mouse->heading);
+}
 
-        case WEST:
-            return (mouse->y == size) ? 1 : maze->hWalls[size - 1 - mouse->y][mouse->x];
-            break;
-    }
+// Returns the number of open cells the mouse's right sensor sees before the nearest wall
+int getRightDistance(Mouse *mouse)
+{
+    return getWallDistance(mouse->maze, mouse->x, mouse->y, (mouse->heading + 1) % 4);
 }
@@ -1,35 +1,70 @@
 #ifndef MOUSE_H
 #define MOUSE_H
 
+#ifndef HEADLESS
 #include <SDL2/SDL.h>
+#endif
 #include "maze.h"
 
 // Encode headings and actions for readability
 typedef enum Heading {NORTH, EAST, SOUTH, WEST} Heading;
 typedef enum Action {LEFT, FORWARD, RIGHT, IDLE} Action;
 
+// Solver state is defined in solver.h; each mouse carries its own so simulations can run side by side
+struct SolverState;
+
+// Physical state of the mouse's body, defined in motion.h
+struct MotionState;
+
+// Recorder of the mouse's decisions, defined in trace.h
+struct TraceWriter;
+
+#define TRAIL_LENGTH 64             // Cell centers kept in each mouse's trail
+
 typedef struct
 {
     int x;
     int y;
-    int absX;
-    int absY;
-    int absA;
     int heading;
     int action;
     Maze* maze;
+    int solver;                     // Index of the mouse's solver in the solvers table
+    struct SolverState* state;      // State kept by the solver between decisions
+    struct MotionState* motion;     // Body driven through the solver's actions to time the run, NULL to not time it
+    struct TraceWriter* trace;      // Trace the solver's decisions are recorded to, NULL to not record them
+#ifndef HEADLESS
     SDL_Texture* mouseTexture;
     SDL_Rect mouseRect;
     SDL_Point mouseCenter;
+    float fromX, fromY, fromA;      // Pose of the body at the start of the current simulation tick
+    float drawX, drawY, drawA;      // Pose the mouse is drawn in, in cells and degrees
+    SDL_Color color;                // Color of the mouse's trail, also used to tint its body
+    int trailX[TRAIL_LENGTH];       // Last cell centers the body passed, oldest overwritten first
+    int trailY[TRAIL_LENGTH];
+    int trailCount;
+    int trailNext;
+#endif
 } Mouse;
 
-int loadMouse(Mouse* mouse);
+void initMouse(Mouse* mouse, Maze* maze);
+void placeMouse(Mouse* mouse, int x, int y, Heading heading);
+int performAction(Mouse* mouse, Action action);
 int getLeftReading(Mouse *mouse);
 int getFrontReading(Mouse *mouse);
 int getRightReading(Mouse *mouse);
-void updateRect(Mouse *mouse);
-int renderMouse(Mouse *mouse);
+int getLeftDistance(Mouse *mouse);
+int getFrontDistance(Mouse *mouse);
+int getRightDistance(Mouse *mouse);
 Heading getHeading(Mouse *mouse);
+#ifndef HEADLESS
+int loadMouse(Mouse* mouse, Maze* maze);
+void updateRect(Mouse *mouse);
+SDL_Rect getMouseBounds(Mouse *mouse);
+void updateMousePose(Mouse *mouse, float fraction);
+void renderMouse(Mouse *mouse);
+void renderMice(Mouse *mice, int count);
 Action getNextAction(Mouse *mouse);
+int stepMouse(Mouse *mouse);
+#endif
 
 #endif
@@ -0,0 +1,336 @@
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "pack.h"
+
+// Access global variables from main.c
+extern int MAX_MAZE_SIZE, MIN_MAZE_SIZE;
+
+// Returns the number of bytes in the record of a maze of the given size, rounded up to keep records 8-byte aligned
+size_t getRecordSize(int size)
+{
+    size_t bytes = (size_t) 2 * ((size + 7) / 8) * size;
+    return (bytes + 7) & ~(size_t) 7;
+}
+
+// FNV-1a hash of a record, stored in the index to detect damaged packs
+uint64_t hashRecord(const uint8_t *record, size_t length)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < length; i++)
+    {
+        hash ^= record[i];
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+// Maps a pack file into memory and checks its header and index
+// Returns 1 on success, 0 if the file could not be read or is not a valid pack
+int openPack(MazePack *pack, const char *path)
+{
+    memset(pack, 0, sizeof(*pack));
+
+    int file = open(path, O_RDONLY);
+    struct stat info;
+    if(file < 0 || fstat(file, &info))
+    {
+        printf("Error: Could not open file %s\n", path);
+        if(file >= 0) close(file);
+        return 0;
+    }
+    if((size_t) info.st_size < sizeof(PackHeader))
+    {
+        printf("Error: %s is not a maze pack\n", path);
+        close(file);
+        return 0;
+    }
+    void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(data == MAP_FAILED)
+    {
+        printf("Error: Could not read file %s\n", path);
+        return 0;
+    }
+    pack->data = data;
+    pack->length = info.st_size;
+
+    const PackHeader *header = data;
+    if(memcmp(header->magic, PACK_MAGIC, 4) || header->version != PACK_VERSION)
+    {
+        printf("Error: %s is not a version %d maze pack\n", path, PACK_VERSION);
+        closePack(pack);
+        return 0;
+    }
+    if(header->count > (pack->length - sizeof(PackHeader)) / sizeof(PackEntry))
+    {
+        printf("Error: %s is truncated\n", path);
+        closePack(pack);
+        return 0;
+    }
+    pack->count = header->count;
+    pack->entries = (const PackEntry *) (pack->data + sizeof(PackHeader));
+
+    // Make sure every record lies inside the file and every name is terminated so entries can be used without
+    // further checks
+    for(int i = 0; i < pack->count; i++)
+    {
+        const PackEntry *entry = &pack->entries[i];
+        if(entry->size < (uint32_t) MIN_MAZE_SIZE || entry->size > (uint32_t) MAX_MAZE_SIZE ||
+           entry->offset > pack->length || getRecordSize(entry->size) > pack->length - entry->offset ||
+           !memchr(entry->name, '\0', sizeof(entry->name)) || !memchr(entry->file, '\0', sizeof(entry->file)))
+        {
+            printf("Error: %s has an invalid index entry for maze %d\n", path, i);
+            closePack(pack);
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Unmaps a pack file
+void closePack(MazePack *pack)
+{
+    if(pack->data) munmap((void *) pack->data, pack->length);
+    memset(pack, 0, sizeof(*pack));
+}
+
+// Returns the index of the maze with the given file name (without .txt) or maze name, or -1 if there is none
+int findPackedMaze(const MazePack *pack, const char *name)
+{
+    for(int i = 0; i < pack->count; i++)
+    {
+        const PackEntry *entry = &pack->entries[i];
+        if(!strncmp(entry->file, name, sizeof(entry->file)) || !strncmp(entry->name, name, sizeof(entry->name))) return i;
+    }
+
+    return -1;
+}
+
+// Decodes one maze of a pack into maze, reusing its wall storage when it is already the right size; the record is
+// checked against the hash in the index first, so a damaged pack is reported rather than run
+// Returns 1 on success, 0 if the index is out of range, the record is damaged or memory could not be allocated
+int loadPackedMaze(const MazePack *pack, int index, Maze *maze)
+{
+    if(index < 0 || index >= pack->count) return 0;
+
+    const PackEntry *entry = &pack->entries[index];
+    int size = entry->size;
+    const uint8_t *record = pack->data + entry->offset;
+    if(hashRecord(record, getRecordSize(size)) != entry->hash)
+    {
+        printf("Error: packed maze %d (%s) is damaged: its record does not match the hash in the index\n", index,
+               entry->name);
+        return 0;
+    }
+#ifndef HEADLESS
+    maze->mazeTexture = NULL;
+#endif
+    if(maze->size != size && !clearMaze(maze, size)) return 0;
+    memcpy(maze->name, entry->name, sizeof(maze->name) - 1);
+    maze->name[sizeof(maze->name) - 1] = '\0';
+
+    // Unpack each row's north and east wall bytes into the row bitsets
+    int rowBytes = (size + 7) / 8;
+    int rowWords = maze->rowWords;
+    for(int y = 0; y < size; y++)
+    {
+        const uint8_t *north = record + (size_t) 2 * rowBytes * y;
+        const uint8_t *east = north + rowBytes;
+        for(int w = 0; w < rowWords; w++)
+        {
+            uint64_t northWord = 0, eastWord = 0;
+            for(int b = 0; b < 8 && w * 8 + b < rowBytes; b++)
+            {
+                northWord |= (uint64_t) north[w * 8 + b] << (8 * b);
+                eastWord |= (uint64_t) east[w * 8 + b] << (8 * b);
+            }
+            maze->northWalls[y * rowWords + w] = northWord;
+            maze->eastWalls[y * rowWords + w] = eastWord;
+        }
+
+        // Drop padding bits and keep the east border closed even if the record is damaged
+        int last = size - 1;
+        uint64_t keep = (size & 63) ? (1ULL << (size & 63)) - 1 : ~0ULL;
+        maze->northWalls[y * rowWords + rowWords - 1] &= keep;
+        maze->eastWalls[y * rowWords + rowWords - 1] &= keep;
+        maze->eastWalls[y * rowWords + (last >> 6)] |= 1ULL << (last & 63);
+    }
+
+    // Keep the north border closed as well, then derive the cell wall masks from the bitsets
+    for(int w = 0; w < rowWords; w++) maze->northWalls[(size - 1) * rowWords + w] = ~0ULL;
+    maze->northWalls[size * rowWords - 1] &= (size & 63) ? (1ULL << (size & 63)) - 1 : ~0ULL;
+    updateCellWalls(maze);
+
+    return 1;
+}
+
+// Loads a maze from a pack given a path of the form PACK:NAME or PACK:INDEX
+// Returns 1 on success, 0 if the pack could not be opened or does not hold the maze
+int loadMazeFromPack(Maze *maze, const char *path)
+{
+    char packPath[512];
+    const char *separator = strrchr(path, ':');
+    if(!separator || separator - path >= (int) sizeof(packPath)) return 0;
+    memcpy(packPath, path, separator - path);
+    packPath[separator - path] = '\0';
+
+    MazePack pack;
+    if(!openPack(&pack, packPath)) return 0;
+
+    // Look the maze up by name first; a number that is not also a name selects the maze at that position
+    const char *name = separator + 1;
+    int index = findPackedMaze(&pack, name);
+    char *end;
+    long number = strtol(name, &end, 10);
+    if(index < 0 && *name && !*end) index = number;
+
+    int result = 0;
+    if(index < 0 || index >= pack.count) printf("Error: %s does not contain maze %s\n", packPath, name);
+    else result = loadPackedMaze(&pack, index, maze);
+
+    if(result && mazeMessages)
+    {
+        printf("Successfully opened maze %d of %s\n", index, packPath);
+        printf("Maze name: %s\n", maze->name);
+        printf("Maze size: %d\n", maze->size);
+    }
+
+    closePack(&pack);
+    return result;
+}
+
+// Packs a maze's walls into a record of getRecordSize(maze->size) bytes, copying whole bytes of the row bitsets
+void encodeRecord(const Maze *maze, uint8_t *record)
+{
+    int size = maze->size;
+    int rowBytes = (size + 7) / 8;
+    memset(record, 0, getRecordSize(size));
+    for(int y = 0; y < size; y++)
+    {
+        uint8_t *north = record + (size_t) 2 * rowBytes * y;
+        uint8_t *east = north + rowBytes;
+        const uint64_t *northWords = &maze->northWalls[y * maze->rowWords];
+        const uint64_t *eastWords = &maze->eastWalls[y * maze->rowWords];
+        for(int b = 0; b < rowBytes; b++)
+        {
+            north[b] = northWords[b >> 3] >> (8 * (b & 7));
+            east[b] = eastWords[b >> 3] >> (8 * (b & 7));
+        }
+    }
+}
+
+// Creates a pack file that will hold count mazes, to be added with addToPack and completed with finishPack
+// Returns 1 on success, 0 if the file could not be created
+int beginPack(PackWriter *writer, const char *path, int count)
+{
+    memset(writer, 0, sizeof(*writer));
+    writer->path = path;
+    writer->count = count;
+    writer->offset = sizeof(PackHeader) + (uint64_t) count * sizeof(PackEntry);
+
+    // The index stream fills in entries behind the header while the record stream appends records after the index
+    writer->indexFile = fopen(path, "wb");
+    if(writer->indexFile) writer->recordFile = fopen(path, "r+b");
+    if(!writer->recordFile || fseeko(writer->recordFile, writer->offset, SEEK_SET))
+    {
+        printf("Error: Could not open or create file %s\n", path);
+        if(writer->recordFile) fclose(writer->recordFile);
+        if(writer->indexFile) fclose(writer->indexFile);
+        return 0;
+    }
+
+    PackHeader header = {{0}, PACK_VERSION, count, 0};
+    memcpy(header.magic, PACK_MAGIC, 4);
+    fwrite(&header, sizeof(header), 1, writer->indexFile);
+
+    return 1;
+}
+
+// Appends a maze to a pack being written; file is the name of the text file it came from (may be NULL)
+// Returns 1 on success, 0 if the pack is already full or memory could not be allocated
+int addToPack(PackWriter *writer, Maze *maze, const char *file)
+{
+    if(writer->written >= writer->count)
+    {
+        printf("Error: Too many mazes for pack %s\n", writer->path);
+        return 0;
+    }
+
+    size_t length = getRecordSize(maze->size);
+    if(length > writer->recordSize)
+    {
+        uint8_t *record = realloc(writer->record, length);
+        if(!record)
+        {
+            printf("Error: Unable to allocate memory for %dx%d maze\n", maze->size, maze->size);
+            return 0;
+        }
+        writer->record = record;
+        writer->recordSize = length;
+    }
+    encodeRecord(maze, writer->record);
+
+    PackEntry entry = {{0}};
+    strncpy(entry.name, maze->name, sizeof(entry.name) - 1);
+    if(file)
+    {
+        strncpy(entry.file, file, sizeof(entry.file) - 1);
+        char *extension = strstr(entry.file, ".txt");
+        if(extension && !extension[4]) *extension = '\0';
+    }
+    entry.size = maze->size;
+    entry.offset = writer->offset;
+    entry.hash = hashRecord(writer->record, length);
+    fwrite(&entry, sizeof(entry), 1, writer->indexFile);
+    fwrite(writer->record, 1, length, writer->recordFile);
+
+    writer->offset += length;
+    writer->written++;
+    return 1;
+}
+
+// Closes a pack being written
+// Returns 1 if every maze was added and the file was written successfully, 0 otherwise
+int finishPack(PackWriter *writer)
+{
+    int failed = ferror(writer->indexFile) || ferror(writer->recordFile);
+    failed |= fclose(writer->indexFile) != 0;
+    failed |= fclose(writer->recordFile) != 0;
+    free(writer->record);
+
+    int result = 1;
+    if(failed)
+    {
+        printf("Error: Could not write file %s\n", writer->path);
+        result = 0;
+    }
+    else if(writer->written != writer->count)
+    {
+        printf("Error: Pack %s holds %d of %d mazes\n", writer->path, writer->written, writer->count);
+        result = 0;
+    }
+
+    memset(writer, 0, sizeof(*writer));
+    return result;
+}
+
+// Writes mazes to a new pack file; files holds the name of the text file each maze came from (may be NULL)
+// Returns 1 on success, 0 if the file could not be written
+int savePack(const char *path, Maze *mazes, char **files, int count)
+{
+    PackWriter writer;
+    if(!beginPack(&writer, path, count)) return 0;
+    for(int i = 0; i < count; i++)
+    {
+        if(!addToPack(&writer, &mazes[i], files ? files[i] : NULL)) break;
+    }
+
+    return finishPack(&writer);
+}
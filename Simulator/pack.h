@@ -0,0 +1,70 @@
+#ifndef PACK_H
+#define PACK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "maze.h"
+
+// Maze pack files hold many mazes as fixed-size binary records behind an index, for corpora too large to keep
+// as text files. Layout (little-endian): a PackHeader, then count PackEntry index entries, then the records
+// A record stores two bits per cell, one row at a time from the bottom: the row's north walls followed by its
+// east walls, each padded to a whole byte (bit x of a row is bit x % 8 of byte x / 8). A 16x16 maze takes 64 bytes
+#define PACK_MAGIC "MZPK"
+#define PACK_VERSION 1
+
+typedef struct
+{
+    char magic[4];          // PACK_MAGIC
+    uint32_t version;       // PACK_VERSION
+    uint32_t count;         // Number of mazes
+    uint32_t reserved;
+} PackHeader;
+
+typedef struct
+{
+    char name[64];          // Maze name (first line of the text file)
+    char file[64];          // Name of the text file the maze came from, without the .txt extension
+    uint32_t size;          // Maze dimensions (cells)
+    uint32_t reserved;
+    uint64_t offset;        // Position of the record from the start of the pack file (bytes)
+    uint64_t hash;          // FNV-1a hash of the record
+} PackEntry;
+
+// Pack file mapped read-only into memory; mazes are decoded straight from the mapping
+typedef struct
+{
+    const uint8_t *data;
+    size_t length;
+    int count;
+    const PackEntry *entries;
+} MazePack;
+
+// Pack file being written one maze at a time; the number of mazes is fixed up front so the index and the records
+// can be written in parallel through two streams, without holding the mazes in memory
+typedef struct
+{
+    FILE *indexFile;
+    FILE *recordFile;
+    const char *path;
+    int count;
+    int written;
+    uint64_t offset;        // Position of the next record
+    uint8_t *record;        // Scratch record of recordSize bytes
+    size_t recordSize;
+} PackWriter;
+
+int openPack(MazePack *pack, const char *path);
+void closePack(MazePack *pack);
+int findPackedMaze(const MazePack *pack, const char *name);
+int loadPackedMaze(const MazePack *pack, int index, Maze *maze);
+int loadMazeFromPack(Maze *maze, const char *path);
+int beginPack(PackWriter *writer, const char *path, int count);
+int addToPack(PackWriter *writer, Maze *maze, const char *file);
+int finishPack(PackWriter *writer);
+int savePack(const char *path, Maze *mazes, char **files, int count);
+void encodeRecord(const Maze *maze, uint8_t *record);
+size_t getRecordSize(int size);
+uint64_t hashRecord(const uint8_t *record, size_t length);
+
+#endif
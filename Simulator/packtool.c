@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "maze.h"
+#include "pack.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazeDirectory = "../Mazes/";  // Path to maze folder
+
+int createPack(const char *path);
+int extractPack(const char *path);
+int listPack(const char *path, int verify);
+void printUsage(const char *program);
+
+// MAIN
+// Converts between folders of maze text files and maze pack files
+int main(int argc, char** argv)
+{
+    const char *command = NULL, *packPath = NULL;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--dir") && i + 1 < argc) mazeDirectory = argv[++i];
+        else if(argv[i][0] == '-')
+        {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+        else if(!command) command = argv[i];
+        else if(!packPath) packPath = argv[i];
+        else
+        {
+            printUsage(argv[0]);
+            return -1;
+        }
+    }
+
+    if(!command || !packPath)
+    {
+        printUsage(argv[0]);
+        return -1;
+    }
+
+    // Maze paths are appended to the folder path, so make sure it ends with a separator
+    size_t length = strlen(mazeDirectory);
+    if(length && mazeDirectory[length - 1] != '/')
+    {
+        char *directory = malloc(length + 2);
+        sprintf(directory, "%s/", mazeDirectory);
+        mazeDirectory = directory;
+    }
+
+    mazeMessages = 0;
+    if(!strcmp(command, "create")) return createPack(packPath) ? 0 : -1;
+    if(!strcmp(command, "extract")) return extractPack(packPath) ? 0 : -1;
+    if(!strcmp(command, "list")) return listPack(packPath, 0) ? 0 : -1;
+    if(!strcmp(command, "verify")) return listPack(packPath, 1) ? 0 : -1;
+
+    printUsage(argv[0]);
+    return -1;
+}
+
+// Packs every maze file in the maze folder into a new pack file
+// Returns 1 on success, 0 otherwise
+int createPack(const char *path)
+{
+    Maze *mazes;
+    char **names;
+    int count = loadMazes(&mazes, &names);
+    if(count <= 0)
+    {
+        printf("Error: no valid maze files found in %s\n", mazeDirectory);
+        return 0;
+    }
+
+    int result = savePack(path, mazes, names, count);
+    if(result) printf("Packed %d mazes into %s\n", count, path);
+
+    for(int i = 0; i < count; i++)
+    {
+        freeMaze(&mazes[i]);
+        free(names[i]);
+    }
+    free(mazes);
+    free(names);
+    return result;
+}
+
+// Writes every maze in a pack to a text file in the maze folder, named after the file it was packed from
+// Returns 1 on success, 0 otherwise
+int extractPack(const char *path)
+{
+    MazePack pack;
+    if(!openPack(&pack, path)) return 0;
+
+    Maze maze = {0};
+    int written = 0;
+    for(int i = 0; i < pack.count; i++)
+    {
+        // Mazes packed without a file name are named after their position in the pack
+        char fileName[80];
+        const char *file = pack.entries[i].file;
+        if(file[0]) snprintf(fileName, sizeof(fileName), "%.63s.txt", file);
+        else snprintf(fileName, sizeof(fileName), "maze_%06d.txt", i);
+
+        if(loadPackedMaze(&pack, i, &maze) && saveMaze(&maze, fileName)) written++;
+    }
+    printf("Extracted %d of %d mazes into %s\n", written, pack.count, mazeDirectory);
+    int result = written == pack.count;
+
+    freeMaze(&maze);
+    closePack(&pack);
+    return result;
+}
+
+// Prints the index of a pack, optionally checking every record against its hash
+// Returns 1 on success, 0 if the pack could not be opened or a record is damaged
+int listPack(const char *path, int verify)
+{
+    MazePack pack;
+    if(!openPack(&pack, path)) return 0;
+
+    int damaged = 0;
+    if(!verify) printf("%8s  %-24s %-32s %5s  %-16s\n", "index", "file", "name", "size", "hash");
+    for(int i = 0; i < pack.count; i++)
+    {
+        const PackEntry *entry = &pack.entries[i];
+        if(verify)
+        {
+            if(hashRecord(pack.data + entry->offset, getRecordSize(entry->size)) != entry->hash)
+            {
+                printf("Error: maze %d (%.63s) does not match its hash\n", i, entry->file);
+                damaged++;
+            }
+        }
+        else
+        {
+            printf("%8d  %-24.63s %-32.63s %5u  %016llx\n", i, entry->file, entry->name, entry->size,
+                   (unsigned long long) entry->hash);
+        }
+    }
+    if(verify) printf("%d of %d mazes OK\n", pack.count - damaged, pack.count);
+
+    closePack(&pack);
+    return damaged == 0;
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--dir PATH] create|extract|list|verify PACK\n", program);
+    printf("  create PACK   pack every maze file in the maze folder into PACK\n");
+    printf("  extract PACK  write every maze in PACK to a text file in the maze folder\n");
+    printf("  list PACK     print the index of PACK\n");
+    printf("  verify PACK   check every maze in PACK against its hash\n");
+    printf("  --dir PATH    maze folder (default ../Mazes/)\n");
+}
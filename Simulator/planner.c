@@ -0,0 +1,241 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "planner.h"
+
+// Access global variables from main.c
+extern int MAX_MAZE_SIZE, MIN_MAZE_SIZE;
+
+// Open state with its time so far and its estimated total time to the goal
+typedef struct PlannerEntry
+{
+    double estimate;
+    double time;
+    int state;
+} PlannerEntry;
+
+static const int dx[4] = {0, 1, 0, -1};
+static const int dy[4] = {1, 0, -1, 0};
+
+// Returns the time (s) to drive a straight run of the given number of cells, starting and ending at rest:
+// accelerate to top speed, cruise and brake, or accelerate and brake straight away if the run is too short
+double getRunTime(const PlannerCosts *costs, int cells)
+{
+    double distance = cells * costs->cellLength;
+    double v = costs->maxSpeed, a = costs->acceleration;
+    if(distance >= v * v / a) return distance / v + v / a;
+    return 2 * sqrt(distance / a);
+}
+
+// Sets up a planner for mazes of the given size
+// Returns 1 if successful, 0 otherwise
+int initPlanner(Planner *planner, const PlannerCosts *costs, int size)
+{
+    *planner = (Planner) {0};
+    if(size < MIN_MAZE_SIZE || size > MAX_MAZE_SIZE)
+    {
+        printf("Error: maze size must be between %d and %d\n", MIN_MAZE_SIZE, MAX_MAZE_SIZE);
+        return 0;
+    }
+    if(!(costs->cellLength > 0 && costs->maxSpeed > 0 && costs->acceleration > 0 && costs->turnTime >= 0))
+    {
+        printf("Error: cell length, speed and acceleration must be positive and turn time not negative\n");
+        return 0;
+    }
+
+    // Once a run is long enough to reach top speed and brake from it, every further cell adds one cell at top
+    // speed, so all longer runs can share one state
+    double maxRun = ceil(costs->maxSpeed * costs->maxSpeed / (costs->acceleration * costs->cellLength));
+    if(maxRun > PLANNER_MAX_RUN)
+    {
+        printf("Error: the mouse needs more than %d cells to reach top speed and stop again\n", PLANNER_MAX_RUN);
+        return 0;
+    }
+
+    planner->costs = *costs;
+    planner->size = size;
+    planner->maxRun = maxRun < 1 ? 1 : (int) maxRun;
+
+    size_t states = (size_t) size * size * 4 * (planner->maxRun + 1);
+    planner->runCosts = malloc(sizeof(double) * (planner->maxRun + 1));
+    planner->times = malloc(sizeof(double) * states);
+    planner->arrivals = malloc(sizeof(uint16_t) * states);
+    if(!planner->runCosts || !planner->times || !planner->arrivals)
+    {
+        printf("Error: unable to allocate memory for the planner\n");
+        freePlanner(planner);
+        return 0;
+    }
+
+    for(int run = 0; run <= planner->maxRun; run++)
+    {
+        planner->runCosts[run] = getRunTime(costs, run + 1) - getRunTime(costs, run);
+    }
+
+    return 1;
+}
+
+void freePlanner(Planner *planner)
+{
+    free(planner->runCosts);
+    free(planner->times);
+    free(planner->arrivals);
+    free(planner->heap);
+    free(planner->actions);
+    *planner = (Planner) {0};
+}
+
+// Adds a state to the open heap
+// Returns 1 if successful, 0 if memory could not be allocated
+static int pushState(Planner *planner, double estimate, double time, int state)
+{
+    if(planner->heapCount == planner->heapCapacity)
+    {
+        int capacity = planner->heapCapacity ? planner->heapCapacity * 2 : 1024;
+        PlannerEntry *heap = realloc(planner->heap, sizeof(PlannerEntry) * capacity);
+        if(!heap) return 0;
+        planner->heap = heap;
+        planner->heapCapacity = capacity;
+    }
+
+    PlannerEntry *heap = planner->heap;
+    int i = planner->heapCount++;
+    while(i > 0 && heap[(i - 1) / 2].estimate > estimate)
+    {
+        heap[i] = heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    heap[i] = (PlannerEntry) {estimate, time, state};
+
+    return 1;
+}
+
+// Removes and returns the open state with the lowest estimate
+static PlannerEntry popState(Planner *planner)
+{
+    PlannerEntry *heap = planner->heap;
+    PlannerEntry top = heap[0];
+    PlannerEntry last = heap[--planner->heapCount];
+    int i = 0;
+    while(1)
+    {
+        int child = 2 * i + 1;
+        if(child >= planner->heapCount) break;
+        if(child + 1 < planner->heapCount && heap[child + 1].estimate < heap[child].estimate) child++;
+        if(heap[child].estimate >= last.estimate) break;
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+
+    return top;
+}
+
+// Returns the number of cells from cell (x, y) to the nearest goal cell, ignoring walls
+static int getGoalDistance(int size, int x, int y)
+{
+    int lo = (size - 1) / 2, hi = size / 2;
+    return (x < lo ? lo - x : x > hi ? x - hi : 0) + (y < lo ? lo - y : y > hi ? y - hi : 0);
+}
+
+// Relaxes a transition into state, reached by action from a state with run length fromRun
+// Returns 1 if successful, 0 if memory could not be allocated
+static int reachState(Planner *planner, int state, double time, double remaining, Action action, int fromRun)
+{
+    if(time >= planner->times[state]) return 1;
+    planner->times[state] = time;
+    planner->arrivals[state] = (uint16_t) (action << 8 | fromRun);
+    return pushState(planner, time + remaining, time, state);
+}
+
+// Writes the actions leading to state into planner->actions by walking the arrivals back to start
+// Returns 1 if successful, 0 if memory could not be allocated
+static int tracePath(Planner *planner, int state, int start)
+{
+    int runs = planner->maxRun + 1;
+    int count = 0;
+    for(int s = state; s != start; count++)
+    {
+        int heading = s / runs % 4, cell = s / runs / 4;
+        int action = planner->arrivals[s] >> 8, fromRun = planner->arrivals[s] & 0xFF;
+        if(action == FORWARD) cell -= dy[heading] * planner->size + dx[heading];
+        else heading = (heading + (action == LEFT ? 1 : 3)) % 4;
+        s = (cell * 4 + heading) * runs + fromRun;
+    }
+
+    Action *actions = realloc(planner->actions, sizeof(Action) * (count ? count : 1));
+    if(!actions) return 0;
+    planner->actions = actions;
+    planner->actionCount = count;
+
+    for(int s = state, i = count - 1; s != start; i--)
+    {
+        int heading = s / runs % 4, cell = s / runs / 4;
+        int action = planner->arrivals[s] >> 8, fromRun = planner->arrivals[s] & 0xFF;
+        actions[i] = action;
+        if(action == FORWARD) cell -= dy[heading] * planner->size + dx[heading];
+        else heading = (heading + (action == LEFT ? 1 : 3)) % 4;
+        s = (cell * 4 + heading) * runs + fromRun;
+    }
+
+    return 1;
+}
+
+// Finds the fastest run from cell (x, y) facing heading to any goal cell through the walls in maze, which may be
+// a partially known maze, using A* with the cells left to the goal at top speed as the estimate
+// The actions and predicted time are left in planner->actions, actionCount and time
+// Returns 1 if a run was found, 0 if the goal cannot be reached or the planner failed
+int planRun(Planner *planner, const Maze *maze, int x, int y, Heading heading)
+{
+    planner->actionCount = 0;
+    planner->time = INFINITY;
+    if(maze->size != planner->size)
+    {
+        printf("Error: planner set up for %dx%d mazes, maze is %dx%d\n", planner->size, planner->size, maze->size,
+               maze->size);
+        return 0;
+    }
+
+    int size = planner->size, runs = planner->maxRun + 1;
+    size_t states = (size_t) size * size * 4 * runs;
+    for(size_t i = 0; i < states; i++) planner->times[i] = INFINITY;
+    planner->heapCount = 0;
+
+    double cellTime = planner->runCosts[planner->maxRun];
+    double turnTime = planner->costs.turnTime;
+
+    int start = ((y * size + x) * 4 + heading) * runs;
+    planner->times[start] = 0;
+    int ok = pushState(planner, getGoalDistance(size, x, y) * cellTime, 0, start);
+
+    while(ok && planner->heapCount)
+    {
+        PlannerEntry entry = popState(planner);
+        int state = entry.state;
+        if(entry.time > planner->times[state]) continue;
+
+        int run = state % runs, h = state / runs % 4, cell = state / runs / 4;
+        int cx = cell % size, cy = cell / size;
+        if(isGoal((Maze *) maze, cx, cy))
+        {
+            if(!(ok = tracePath(planner, state, start))) break;
+            planner->time = entry.time;
+            return 1;
+        }
+
+        // Turning in place keeps the estimate, driving on moves it by one cell
+        double remaining = entry.estimate - entry.time;
+        ok = reachState(planner, (cell * 4 + (h + 3) % 4) * runs, entry.time + turnTime, remaining, LEFT, run)
+          && reachState(planner, (cell * 4 + (h + 1) % 4) * runs, entry.time + turnTime, remaining, RIGHT, run);
+        if(ok && !hasWall(maze, cx, cy, h))
+        {
+            int nx = cx + dx[h], ny = cy + dy[h];
+            int next = ((ny * size + nx) * 4 + h) * runs + (run < planner->maxRun ? run + 1 : run);
+            ok = reachState(planner, next, entry.time + planner->runCosts[run],
+                            getGoalDistance(size, nx, ny) * cellTime, FORWARD, run);
+        }
+    }
+
+    if(!ok) printf("Error: unable to allocate memory for the planner\n");
+    return 0;
+}
@@ -0,0 +1,48 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <stdint.h>
+#include "maze.h"
+#include "mouse.h"
+
+// Longest straight run the planner tells apart; runs long enough to reach top speed all cost the same per cell
+#define PLANNER_MAX_RUN 255
+
+// Motion model of a speed run: the mouse accelerates along straights on a trapezoidal speed profile, stopping
+// at the end of each one, and turns 90 degrees in place
+typedef struct
+{
+    double cellLength;              // Length of one cell (m)
+    double maxSpeed;                // Top speed on straights (m/s)
+    double acceleration;            // Acceleration and braking (m/s^2)
+    double turnTime;                // Time of one 90 degree turn (s)
+} PlannerCosts;
+
+// Planner settings, cost tables and search memory sized for one maze size, so many mazes can be planned back
+// to back without allocating
+// The search runs over states (cell, heading, run), run being the number of cells driven straight since the
+// last stop, capped at maxRun; state index is (cell * 4 + heading) * (maxRun + 1) + run
+typedef struct
+{
+    PlannerCosts costs;
+    int size;
+    int maxRun;                     // First run length from which every further cell costs the same
+    double *runCosts;               // runCosts[run]: extra time to extend a run of that length by one cell (s)
+    double *times;                  // Fastest known time to each state (s)
+    uint16_t *arrivals;             // Action that reached each state (high byte) and the run it came from
+    struct PlannerEntry *heap;      // Open states by estimated total time
+    int heapCount;
+    int heapCapacity;
+
+    // Result of the last planRun
+    Action *actions;                // Actions of the fastest run, in order
+    int actionCount;
+    double time;                    // Predicted time of the run (s)
+} Planner;
+
+int initPlanner(Planner *planner, const PlannerCosts *costs, int size);
+void freePlanner(Planner *planner);
+int planRun(Planner *planner, const Maze *maze, int x, int y, Heading heading);
+double getRunTime(const PlannerCosts *costs, int cells);
+
+#endif
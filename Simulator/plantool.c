@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "maze.h"
+#include "mouse.h"
+#include "planner.h"
+#include "distance.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazeDirectory = "../Mazes/";  // Path to maze folder
+int printActions = 0;               // 1 to print each run's actions after the results
+
+// Output formats
+typedef enum Format {TABLE, CSV, JSON} Format;
+Format format = TABLE;
+
+// Fastest run found on one maze
+typedef struct
+{
+    char maze[256];
+    int size;
+    int found;          // 1 if the goal can be reached
+    long cells;         // Cells driven
+    long shortest;      // Fewest cells any run to the goal needs
+    long turns;         // 90 degree turns made
+    long straights;     // Straight runs driven
+    double time;        // Predicted run time (seconds)
+    double planTime;    // Wall-clock time spent planning (seconds)
+    char *actions;      // Actions as a string of L, F and R
+} PlanResult;
+
+void printResults(PlanResult *results, int count);
+void printUsage(const char *program);
+
+// MAIN
+// Plans the fastest run from the start cell to the goal of every maze in the maze folder and reports its
+// predicted time
+int main(int argc, char** argv)
+{
+    PlannerCosts costs = {0.18, 2.0, 5.0, 0.2};
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--cell") && i + 1 < argc) costs.cellLength = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--speed") && i + 1 < argc) costs.maxSpeed = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--accel") && i + 1 < argc) costs.acceleration = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--turn") && i + 1 < argc) costs.turnTime = atof(argv[++i]);
+        else if(!strcmp(argv[i], "--dir") && i + 1 < argc) mazeDirectory = argv[++i];
+        else if(!strcmp(argv[i], "--actions")) printActions = 1;
+        else if(!strcmp(argv[i], "--csv")) format = CSV;
+        else if(!strcmp(argv[i], "--json")) format = JSON;
+        else
+        {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+
+    // Maze paths are appended to the folder path, so make sure it ends with a separator
+    size_t length = strlen(mazeDirectory);
+    if(length && mazeDirectory[length - 1] != '/')
+    {
+        char *directory = malloc(length + 2);
+        sprintf(directory, "%s/", mazeDirectory);
+        mazeDirectory = directory;
+    }
+
+    char **names;
+    int mazeCount = listMazes(&names);
+    if(mazeCount <= 0)
+    {
+        printf("Error: no maze files found in %s\n", mazeDirectory);
+        return -1;
+    }
+
+    PlanResult *results = calloc(mazeCount, sizeof(PlanResult));
+    if(!results) return -1;
+
+    // The planner's memory is reused for consecutive mazes of the same size
+    mazeMessages = 0;
+    int count = 0, status = 0;
+    Maze maze = {0};
+    Planner planner = {0};
+    int *distances = NULL;
+    for(int m = 0; m < mazeCount; m++)
+    {
+        if(!loadMaze(&maze, names[m])) continue;
+        if(maze.size != planner.size)
+        {
+            freePlanner(&planner);
+            free(distances);
+            distances = malloc(sizeof(int) * maze.size * maze.size);
+            if(!distances || !initPlanner(&planner, &costs, maze.size))
+            {
+                status = -1;
+                break;
+            }
+        }
+
+        PlanResult *result = &results[count++];
+        strncpy(result->maze, names[m], sizeof(result->maze) - 1);
+        result->size = maze.size;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        result->found = planRun(&planner, &maze, 0, 0, NORTH);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        result->planTime = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+        if(!result->found) continue;
+
+        computeDistances(&maze, distances);
+        result->shortest = distances[0];
+        result->time = planner.time;
+        result->actions = malloc(planner.actionCount + 1);
+        for(int i = 0; i < planner.actionCount; i++)
+        {
+            Action action = planner.actions[i];
+            result->actions[i] = action == LEFT ? 'L' : action == RIGHT ? 'R' : 'F';
+            if(action != FORWARD) result->turns++;
+            else
+            {
+                if(!i || planner.actions[i - 1] != FORWARD) result->straights++;
+                result->cells++;
+            }
+        }
+        result->actions[planner.actionCount] = '\0';
+    }
+
+    printResults(results, count);
+
+    freePlanner(&planner);
+    free(distances);
+    freeMaze(&maze);
+    for(int m = 0; m < mazeCount; m++) free(names[m]);
+    free(names);
+    for(int i = 0; i < count; i++) free(results[i].actions);
+    free(results);
+    return status;
+}
+
+// Prints results as an aligned table, CSV or JSON
+void printResults(PlanResult *results, int count)
+{
+    if(format == TABLE)
+    {
+        printf("%-24s %5s %5s %6s %9s %6s %10s %10s %10s\n",
+               "maze", "size", "goal", "cells", "shortest", "turns", "straights", "time (s)", "plan (ms)");
+    }
+    else if(format == CSV) printf("maze,size,reached_goal,cells,shortest,turns,straights,time_s,plan_ms\n");
+    else printf("[\n");
+
+    for(int i = 0; i < count; i++)
+    {
+        PlanResult *r = &results[i];
+        if(format == TABLE)
+        {
+            printf("%-24s %5d %5s %6ld %9ld %6ld %10ld %10.3f %10.3f\n", r->maze, r->size, r->found ? "yes" : "no",
+                   r->cells, r->shortest, r->turns, r->straights, r->time, r->planTime * 1e3);
+        }
+        else if(format == CSV)
+        {
+            printf("%s,%d,%d,%ld,%ld,%ld,%ld,%.6f,%.6f\n", r->maze, r->size, r->found, r->cells, r->shortest,
+                   r->turns, r->straights, r->time, r->planTime * 1e3);
+        }
+        else
+        {
+            printf("  {\"maze\": \"%s\", \"size\": %d, \"reached_goal\": %s, \"cells\": %ld, \"shortest\": %ld, "
+                   "\"turns\": %ld, \"straights\": %ld, \"time_s\": %.6f, \"plan_ms\": %.6f",
+                   r->maze, r->size, r->found ? "true" : "false", r->cells, r->shortest, r->turns, r->straights,
+                   r->time, r->planTime * 1e3);
+            if(printActions) printf(", \"actions\": \"%s\"", r->actions ? r->actions : "");
+            printf("}%s\n", (i < count - 1) ? "," : "");
+        }
+    }
+
+    if(format == JSON) printf("]\n");
+    else if(printActions)
+    {
+        for(int i = 0; i < count; i++)
+        {
+            if(results[i].actions) printf("%s%s%s\n", results[i].maze, format == CSV ? "," : ": ", results[i].actions);
+        }
+    }
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--dir PATH] [--cell M] [--speed M/S] [--accel M/S^2] [--turn S] [--actions] [--csv | --json]\n",
+           program);
+    printf("  --dir PATH     folder of maze files to plan (default ../Mazes/)\n");
+    printf("  --cell M       cell length in meters (default 0.18)\n");
+    printf("  --speed M/S    top speed on straights (default 2.0)\n");
+    printf("  --accel M/S^2  acceleration and braking (default 5.0)\n");
+    printf("  --turn S       time of one 90 degree turn in place (default 0.2)\n");
+    printf("  --actions      also print each run's actions (L = left, F = forward, R = right)\n");
+    printf("  --csv          print results as CSV\n");
+    printf("  --json         print results as JSON\n");
+}
@@ -0,0 +1,255 @@
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "plugin.h"
+#include "solver.h"
+#include "mouse.h"
+
+// Plugins use their own copies of the heading and action values
+_Static_assert(PLUGIN_WEST == WEST && PLUGIN_IDLE == IDLE, "plugin.h values must match mouse.h");
+
+// A solver plugin and the version of its shared object that is currently loaded
+typedef struct LoadedPlugin
+{
+    char path[512];
+    char name[64];
+    void *handle;
+    const SolverPlugin *api;
+    struct timespec loadedTime;     // Modification time and size of the file that was loaded
+    off_t loadedSize;
+    struct timespec triedTime;      // Modification time and size of the last file a load was attempted from
+    off_t triedSize;
+} LoadedPlugin;
+
+// Returns 1 if name looks like a path to a shared object rather than a solver name
+static int isPluginPath(const char *name)
+{
+    size_t length = strlen(name);
+    return strchr(name, '/') || (length > 3 && !strcmp(name + length - 3, ".so"));
+}
+
+// Opens a private copy of the plugin's shared object so a compiler can rewrite the original while it is loaded
+// and so dlopen does not hand back the previously loaded version; the currently loaded version, if any, is left
+// in place. api and info receive the new version's callbacks and file details
+// Returns the handle of the new version, or NULL if it could not be loaded
+static void *openPluginObject(LoadedPlugin *plugin, const SolverPlugin **api, struct stat *info)
+{
+    if(stat(plugin->path, info))
+    {
+        printf("Error: unable to open solver plugin %s\n", plugin->path);
+        return NULL;
+    }
+    plugin->triedTime = info->st_mtim;
+    plugin->triedSize = info->st_size;
+
+    // Copy the shared object to a temporary file
+    char copyPath[] = "/tmp/solverPluginXXXXXX.so";
+    int copy = mkstemps(copyPath, 3);
+    FILE *source = fopen(plugin->path, "rb");
+    if(copy < 0 || !source)
+    {
+        printf("Error: unable to copy solver plugin %s\n", plugin->path);
+        if(copy >= 0)
+        {
+            close(copy);
+            unlink(copyPath);
+        }
+        if(source) fclose(source);
+        return NULL;
+    }
+    char buffer[65536];
+    size_t count;
+    int copied = 1;
+    while((count = fread(buffer, 1, sizeof(buffer), source)) > 0)
+    {
+        if(write(copy, buffer, count) != (ssize_t) count) copied = 0;
+    }
+    fclose(source);
+    close(copy);
+
+    void *handle = copied ? dlopen(copyPath, RTLD_NOW | RTLD_LOCAL) : NULL;
+    unlink(copyPath);
+    if(!handle)
+    {
+        printf("Error: unable to load solver plugin %s: %s\n", plugin->path, copied ? dlerror() : "copy failed");
+        return NULL;
+    }
+
+    // Look up and check the solver callbacks
+    GetSolverPlugin getPlugin = (GetSolverPlugin) dlsym(handle, SOLVER_PLUGIN_ENTRY);
+    *api = getPlugin ? getPlugin() : NULL;
+    if(!*api || (*api)->abi != SOLVER_PLUGIN_ABI || !(*api)->name || !(*api)->decide)
+    {
+        if(!getPlugin) printf("Error: solver plugin %s does not export %s\n", plugin->path, SOLVER_PLUGIN_ENTRY);
+        else if(*api && (*api)->abi != SOLVER_PLUGIN_ABI)
+        {
+            printf("Error: solver plugin %s was built for plugin ABI %d, expected %d\n", plugin->path, (*api)->abi,
+                   SOLVER_PLUGIN_ABI);
+        }
+        else printf("Error: solver plugin %s is missing its name or decide callback\n", plugin->path);
+        dlclose(handle);
+        return NULL;
+    }
+    return handle;
+}
+
+// Replaces the loaded version of the plugin with a newly opened one, unloading the old version
+static void installPlugin(LoadedPlugin *plugin, void *handle, const SolverPlugin *api, const struct stat *info)
+{
+    if(plugin->handle) dlclose(plugin->handle);
+    plugin->handle = handle;
+    plugin->api = api;
+    plugin->loadedTime = info->st_mtim;
+    plugin->loadedSize = info->st_size;
+}
+
+// Loads the current version of the plugin's shared object, replacing the loaded version if there is one
+// Returns 1 if the plugin was loaded, 0 otherwise (the currently loaded version, if any, is left in place)
+static int openPlugin(LoadedPlugin *plugin)
+{
+    const SolverPlugin *api;
+    struct stat info;
+    void *handle = openPluginObject(plugin, &api, &info);
+    if(!handle) return 0;
+    installPlugin(plugin, handle, api, &info);
+    return 1;
+}
+
+// Loads a solver plugin from a shared object and adds it to the solvers table under the name it reports
+// Returns the index of the new solver, or -1 on error
+int loadSolverPlugin(const char *path)
+{
+    LoadedPlugin *plugin = calloc(1, sizeof(LoadedPlugin));
+    if(!plugin) return -1;
+
+    snprintf(plugin->path, sizeof(plugin->path), "%s", path);
+    if(!openPlugin(plugin))
+    {
+        free(plugin);
+        return -1;
+    }
+    snprintf(plugin->name, sizeof(plugin->name), "%s", plugin->api->name);
+
+    int index = registerSolver(plugin->name, pluginSolver, plugin);
+    if(index < 0)
+    {
+        printf("Error: solver plugin %s uses the name %s, which is already taken\n", path, plugin->name);
+        dlclose(plugin->handle);
+        free(plugin);
+    }
+    return index;
+}
+
+// Returns the index of a solver given its name, or loads it if given the path to a plugin's shared object
+// Returns -1 if there is no such solver or the plugin could not be loaded
+int findOrLoadSolver(const char *name)
+{
+    if(!isPluginPath(name)) return findSolver(name);
+
+    for(int i = 0; i < solverCount; i++)
+    {
+        if(solvers[i].plugin && !strcmp(solvers[i].plugin->path, name)) return i;
+    }
+    return loadSolverPlugin(name);
+}
+
+// Returns 1 if the plugin's shared object has changed on disk since it was loaded and this version has not been
+// tried yet, 0 otherwise
+static int hasPluginChanged(const LoadedPlugin *plugin)
+{
+    struct stat info;
+    if(stat(plugin->path, &info)) return 0;
+    if(info.st_size == plugin->loadedSize && info.st_mtim.tv_sec == plugin->loadedTime.tv_sec &&
+       info.st_mtim.tv_nsec == plugin->loadedTime.tv_nsec) return 0;
+
+    // Only try each version of the file once so a broken build does not print an error on every check
+    return info.st_size != plugin->triedSize || info.st_mtim.tv_sec != plugin->triedTime.tv_sec ||
+           info.st_mtim.tv_nsec != plugin->triedTime.tv_nsec;
+}
+
+// Reloads every plugin providing one of the mice's solvers whose shared object has changed on disk, replacing
+// the plugin instances of all mice using it. A version that fails to load leaves the old code and the mice's
+// instances untouched
+// Returns 1 if any plugin was reloaded, 0 otherwise
+int reloadSolverPlugins(Mouse *mice, int count)
+{
+    int reloaded = 0;
+    for(int i = 0; i < count; i++)
+    {
+        LoadedPlugin *plugin = solvers[mice[i].solver].plugin;
+        if(!plugin || !hasPluginChanged(plugin)) continue;
+
+        const SolverPlugin *api;
+        struct stat info;
+        void *handle = openPluginObject(plugin, &api, &info);
+        if(!handle) continue;
+
+        // Instances must be torn down by the code that created them, before that code is unloaded
+        for(int j = 0; j < count; j++)
+        {
+            if(solvers[mice[j].solver].plugin == plugin) freePluginInstance(mice[j].state);
+        }
+        installPlugin(plugin, handle, api, &info);
+
+        printf("Reloaded solver plugin %s\n", plugin->path);
+        reloaded = 1;
+    }
+    return reloaded;
+}
+
+// Solver function of every plugin solver: creates the mouse's plugin instance if needed and asks the plugin
+// for the next action
+Action pluginSolver(Mouse *mouse)
+{
+    SolverState *state = mouse->state;
+    const SolverPlugin *api = solvers[mouse->solver].plugin->api;
+    int size = mouse->maze->size;
+
+    // The instance belongs to a different solver or maze size, so create a new one
+    if(state->pluginReady && (state->pluginSolver != mouse->solver || state->pluginMazeSize != size))
+    {
+        freePluginInstance(state);
+    }
+    if(!state->pluginReady)
+    {
+        state->pluginInstance = api->init ? api->init(size) : NULL;
+        if(api->init && !state->pluginInstance) return IDLE;
+        state->pluginReady = 1;
+        state->pluginSolver = mouse->solver;
+        state->pluginMazeSize = size;
+    }
+
+    PluginSensors sensors = {mouse->x, mouse->y, mouse->heading, size,
+                             getLeftReading(mouse), getFrontReading(mouse), getRightReading(mouse),
+                             getLeftDistance(mouse), getFrontDistance(mouse), getRightDistance(mouse)};
+    int action = api->decide(state->pluginInstance, &sensors);
+    return (action >= LEFT && action <= IDLE) ? action : IDLE;
+}
+
+// Resets the mouse's plugin instance for a new run, or frees it if it belongs to a different solver
+void resetPluginInstance(Mouse *mouse)
+{
+    SolverState *state = mouse->state;
+    if(!state->pluginReady) return;
+
+    if(state->pluginSolver != mouse->solver) freePluginInstance(state);
+    else
+    {
+        const SolverPlugin *api = solvers[state->pluginSolver].plugin->api;
+        if(api->reset) api->reset(state->pluginInstance);
+    }
+}
+
+// Frees the plugin instance held in a solver state
+void freePluginInstance(SolverState *state)
+{
+    if(!state->pluginReady) return;
+
+    const SolverPlugin *api = solvers[state->pluginSolver].plugin->api;
+    if(api->teardown) api->teardown(state->pluginInstance);
+    state->pluginInstance = NULL;
+    state->pluginReady = 0;
+}
@@ -0,0 +1,43 @@
+#ifndef PLUGIN_H
+#define PLUGIN_H
+
+// Interface between the simulator and solver plugins. A plugin is a shared object that exports
+// getSolverPlugin() and needs no other simulator headers, e.g.
+//     gcc -shared -fPIC -O2 -o mySolver.so mySolver.c
+// The layout of everything in this file is fixed for a given SOLVER_PLUGIN_ABI; change the number whenever
+// it changes so stale plugins are rejected instead of misbehaving
+
+#define SOLVER_PLUGIN_ABI 2
+#define SOLVER_PLUGIN_ENTRY "getSolverPlugin"
+
+// Headings and actions; values match Heading and Action in mouse.h
+enum {PLUGIN_NORTH, PLUGIN_EAST, PLUGIN_SOUTH, PLUGIN_WEST};
+enum {PLUGIN_LEFT, PLUGIN_FORWARD, PLUGIN_RIGHT, PLUGIN_IDLE};
+
+// What the mouse knows when it has to make a decision
+typedef struct
+{
+    int x, y;               // Current cell, (0, 0) is the bottom left corner
+    int heading;            // PLUGIN_NORTH, PLUGIN_EAST, PLUGIN_SOUTH or PLUGIN_WEST
+    int mazeSize;           // Maze dimensions (cells)
+    int left, front, right; // Sensor readings: 1 if there is a wall on that side of the current cell
+    int leftDistance;       // Long-range sensor readings: open cells between the current cell and the nearest
+    int frontDistance;      // wall on that side, 0 if there is a wall right next to it
+    int rightDistance;
+} PluginSensors;
+
+// Solver callbacks. One instance is created per mouse and passed back to every other callback; several
+// instances may run on different threads at once, so keep all state in the instance
+typedef struct
+{
+    int abi;                                                        // Must be SOLVER_PLUGIN_ABI
+    const char *name;                                               // Name used to select the solver
+    void *(*init)(int mazeSize);                                    // Creates an instance, NULL on failure (optional)
+    int (*decide)(void *instance, const PluginSensors *sensors);    // Returns the next action
+    void (*reset)(void *instance);                                  // Prepares for a new run (optional)
+    void (*teardown)(void *instance);                               // Frees an instance (optional)
+} SolverPlugin;
+
+typedef const SolverPlugin *(*GetSolverPlugin)(void);
+
+#endif
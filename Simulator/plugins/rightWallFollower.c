@@ -0,0 +1,49 @@
+#include <stdlib.h>
+#include "../plugin.h"
+
+// Example solver plugin: right wall following, the mirror image of the built-in leftWallFollower
+// Build with make plugins and run with ./simulation default.txt plugins/rightWallFollower.so
+
+typedef struct
+{
+    int turnedRight;
+} Instance;
+
+static void *init(int mazeSize)
+{
+    return calloc(1, sizeof(Instance));
+}
+
+static int decide(void *instance, const PluginSensors *sensors)
+{
+    Instance *self = instance;
+    if(self->turnedRight)
+    {
+        self->turnedRight = 0;
+        return PLUGIN_FORWARD;
+    }
+    else if(!sensors->right)
+    {
+        self->turnedRight = 1;
+        return PLUGIN_RIGHT;
+    }
+    else if(!sensors->front) return PLUGIN_FORWARD;
+    else return PLUGIN_LEFT;
+}
+
+static void reset(void *instance)
+{
+    ((Instance *) instance)->turnedRight = 0;
+}
+
+static void teardown(void *instance)
+{
+    free(instance);
+}
+
+static const SolverPlugin plugin = {SOLVER_PLUGIN_ABI, "rightWallFollower", init, decide, reset, teardown};
+
+const SolverPlugin *getSolverPlugin(void)
+{
+    return &plugin;
+}
@@ -0,0 +1,147 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "runner.h"
+#include "symmetry.h"
+
+// Number of jobs a worker claims at once; small enough to balance uneven run lengths, large enough to keep
+// workers from contending on the shared job counter
+#define JOB_CHUNK 4
+
+// Size of each worker's trace ring buffer (bytes), enough to ride out a slow disk for a few hundred thousand
+// decisions
+#define TRACE_BUFFER_SIZE (1 << 20)
+
+// Job list shared by all workers; mazes are only read, and each job's results are written by the one worker
+// that claimed it, so results do not depend on the number of threads or on scheduling
+typedef struct
+{
+    Maze *mazes;
+    const MazePack *pack;   // If set, mazes are decoded from the pack instead of taken from mazes
+    RunJob *jobs;
+    long jobCount;
+    const RunOptions *options;
+    atomic_long nextJob;
+} JobQueue;
+
+// Worker thread: claims chunks of jobs until none are left, reusing one simulation context (and trace writer)
+// for all of them. Rotated and reflected mazes are built from the walls of the maze as stored when a job asks for
+// them, and kept for the jobs that follow on the same maze
+static void *runWorker(void *arg)
+{
+    JobQueue *queue = arg;
+    const RunOptions *options = queue->options;
+    SimContext context;
+    initContext(&context, NULL, 0);
+    setSolverBudget(&context.state, options->memoryBudget);
+    if(options->motion) enableMotion(&context, options->motion);
+    TraceWriter trace = {0};
+    if(options->traceDirectory && initTraceWriter(&trace, TRACE_BUFFER_SIZE)) context.mouse.trace = &trace;
+    Maze packed = {0};
+    int packedIndex = -1;
+    Maze variants[SYMMETRY_COUNT] = {{0}};
+    int variantMaze[SYMMETRY_COUNT];
+    for(int s = 0; s < SYMMETRY_COUNT; s++) variantMaze[s] = -1;
+
+    while(1)
+    {
+        long first = atomic_fetch_add(&queue->nextJob, JOB_CHUNK);
+        if(first >= queue->jobCount) break;
+
+        long last = first + JOB_CHUNK;
+        if(last > queue->jobCount) last = queue->jobCount;
+        for(long i = first; i < last; i++)
+        {
+            RunJob *job = &queue->jobs[i];
+            job->failed = 1;
+            if(queue->pack)
+            {
+                // Jobs are ordered by maze, so a worker usually decodes each maze it runs once
+                if(job->maze != packedIndex)
+                {
+                    packedIndex = -1;
+                    if(!loadPackedMaze(queue->pack, job->maze, &packed)) continue;
+                    packedIndex = job->maze;
+                }
+                context.mouse.maze = &packed;
+            }
+            else context.mouse.maze = &queue->mazes[job->maze];
+
+            // The goal is the center of the maze, which every symmetry keeps in place, so only the start moves
+            StartConfig start = job->start;
+            if(job->symmetry)
+            {
+                Maze *variant = &variants[job->symmetry];
+                if(variantMaze[job->symmetry] != job->maze)
+                {
+                    variantMaze[job->symmetry] = -1;
+                    if(!transformMaze(context.mouse.maze, job->symmetry, variant)) continue;
+                    variantMaze[job->symmetry] = job->maze;
+                }
+                transformCell(variant->size, job->symmetry, &start.x, &start.y);
+                start.heading = transformHeading(job->symmetry, start.heading);
+                context.mouse.maze = variant;
+            }
+            context.mouse.solver = job->solver;
+            startRun(&context, start);
+            if(options->traceDirectory)
+            {
+                char path[4096];
+                snprintf(path, sizeof(path), "%s/run_%07ld.trace", options->traceDirectory, i);
+                if(!context.mouse.trace || !beginTrace(&trace, path, context.mouse.maze, solvers[job->solver].name))
+                {
+                    continue;
+                }
+            }
+            simulate(&context.mouse, options->maxSteps, &job->stats);
+            endTrace(&trace);
+            job->failed = 0;
+        }
+    }
+
+    freeTraceWriter(&trace);
+    freeContext(&context);
+    freeMaze(&packed);
+    for(int s = 0; s < SYMMETRY_COUNT; s++) freeMaze(&variants[s]);
+    return NULL;
+}
+
+// Runs every job, spreading them over the given number of threads, and stores each job's results in the job
+// Mazes are taken from the pack if one is given, otherwise from the mazes array; jobs that could not be set up
+// are marked failed and have no results
+// Each worker's solver arena is reset between its runs, not freed, so runs after the first allocate nothing
+// Returns 1 on success, 0 if memory could not be allocated
+int runJobs(Maze *mazes, const MazePack *pack, RunJob *jobs, long jobCount, const RunOptions *options, int threads)
+{
+    JobQueue queue = {mazes, pack, jobs, jobCount, options};
+    atomic_init(&queue.nextJob, 0);
+
+    if(threads < 1) threads = 1;
+    if(threads > jobCount) threads = jobCount > 0 ? jobCount : 1;
+
+    // The calling thread works too, so only threads - 1 extra threads are started
+    pthread_t *workers = malloc(sizeof(pthread_t) * threads);
+    if(!workers) return 0;
+    int started = 0;
+    for(int i = 1; i < threads; i++)
+    {
+        if(pthread_create(&workers[started], NULL, runWorker, &queue)) break;
+        started++;
+    }
+    if(started < threads - 1) printf("Warning: only %d of %d worker threads started\n", started + 1, threads);
+
+    runWorker(&queue);
+    for(int i = 0; i < started; i++) pthread_join(workers[i], NULL);
+
+    free(workers);
+    return 1;
+}
+
+// Returns the number of processor cores available
+int getCoreCount()
+{
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? cores : 1;
+}
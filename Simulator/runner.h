@@ -0,0 +1,30 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include "simulate.h"
+#include "pack.h"
+
+// One simulation in a batch: which maze, solver and start to run, and the results once it has run
+typedef struct
+{
+    int maze;           // Index into the maze array (or pack) passed to runJobs
+    int solver;         // Index into the solvers table
+    int symmetry;       // Rotation or reflection of the maze to run it in (see symmetry.h), 0 for the maze as stored
+    StartConfig start;  // Start in the maze as stored; moved along with the maze for other symmetries
+    int failed;         // 1 if the run could not be set up (maze not decoded or transformed, trace not started)
+    SimStats stats;
+} RunJob;
+
+// Settings shared by every run in a batch
+typedef struct
+{
+    long maxSteps;                  // Solver decisions after which a run is stopped
+    const MotionProfile *motion;    // If set, runs are timed with this motion profile
+    const char *traceDirectory;     // If set, each job's decisions are recorded to a trace file in this folder
+    size_t memoryBudget;            // Memory a solver may allocate in a run (bytes), 0 for no limit
+} RunOptions;
+
+int runJobs(Maze *mazes, const MazePack *pack, RunJob *jobs, long jobCount, const RunOptions *options, int threads);
+int getCoreCount();
+
+#endif
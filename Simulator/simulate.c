@@ -0,0 +1,126 @@
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "simulate.h"
+
+// Returns a monotonic timestamp (seconds)
+double getTime()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Prepares a context to run the given solver on a maze
+void initContext(SimContext *context, Maze *maze, int solver)
+{
+    memset(context, 0, sizeof(*context));
+    initMouse(&context->mouse, maze);
+    context->mouse.solver = solver;
+    context->mouse.state = &context->state;
+}
+
+// Times the context's runs by driving a body with the given profile through the solver's actions
+void enableMotion(SimContext *context, const MotionProfile *profile)
+{
+    initMotion(&context->motion, profile);
+    context->mouse.motion = &context->motion;
+}
+
+// Places the mouse at a start position and clears its solver's state
+void startRun(SimContext *context, StartConfig start)
+{
+    placeMouse(&context->mouse, start.x, start.y, start.heading);
+    resetSolver(&context->mouse);
+}
+
+// Frees memory held by a context; the maze is not touched
+void freeContext(SimContext *context)
+{
+    freeSolverState(&context->state);
+}
+
+// Fills starts with the eight corner start configurations of a maze of the given size (each corner, facing
+// along either wall)
+// Returns the number of configurations
+int getCornerStarts(int size, StartConfig starts[8])
+{
+    int n = size - 1;
+    StartConfig corners[8] = {
+        {0, 0, NORTH}, {0, 0, EAST},
+        {n, 0, NORTH}, {n, 0, WEST},
+        {0, n, SOUTH}, {0, n, EAST},
+        {n, n, SOUTH}, {n, n, WEST}
+    };
+    memcpy(starts, corners, sizeof(corners));
+
+    return 8;
+}
+
+// Drives the solver without rendering until the mouse reaches the goal, crashes, idles or runs out of steps
+// If the mouse has a body, the body is driven along behind the solver, which is asked for each action only when
+// the body needs it, and the run is timed until the body comes to rest
+// If the mouse has a trace writer, every decision, including a final idle, is recorded to it
+// Returns 1 if the goal was reached, 0 otherwise
+int simulate(Mouse *mouse, long maxSteps, SimStats *stats)
+{
+    SimStats result = {0};
+    int size = mouse->maze->size;
+    char *visited = calloc((size_t) size * size, 1);
+    if(visited)
+    {
+        visited[mouse->y * size + mouse->x] = 1;
+        result.cellsVisited = 1;
+    }
+    double start = getTime();
+
+    MotionState *motion = mouse->motion;
+    while(result.steps < maxSteps && !isGoal(mouse->maze, mouse->x, mouse->y))
+    {
+        if(motion) while(!needsAction(motion)) stepMotion(motion);
+
+        Action action = solver(mouse);
+        result.steps++;
+        if(mouse->trace) recordDecision(mouse->trace, mouse, action);
+
+        if(action == IDLE) break;
+
+        if(!performAction(mouse, action))
+        {
+            result.crashed = 1;
+            break;
+        }
+        if(motion) commitAction(motion, action);
+
+        if(action == FORWARD)
+        {
+            result.moves++;
+            if(visited && !visited[mouse->y * size + mouse->x])
+            {
+                visited[mouse->y * size + mouse->x] = 1;
+                result.cellsVisited++;
+            }
+        }
+        else result.turns++;
+    }
+
+    if(motion)
+    {
+        while(!isAtRest(motion)) stepMotion(motion);
+        result.runTime = motion->time;
+    }
+
+    if(mouse->state)
+    {
+        result.memoryUsed = mouse->state->arena.used;
+        result.allocations = mouse->state->arena.allocations;
+        result.overBudget = mouse->state->arena.exceeded;
+    }
+
+    result.reachedGoal = isGoal(mouse->maze, mouse->x, mouse->y);
+    result.elapsed = getTime() - start;
+    free(visited);
+    if(stats) *stats = result;
+
+    return result.reachedGoal;
+}
@@ -0,0 +1,48 @@
+#ifndef SIMULATE_H
+#define SIMULATE_H
+
+#include "mouse.h"
+#include "solver.h"
+#include "motion.h"
+#include "trace.h"
+
+// Results of a single simulation run
+typedef struct
+{
+    long steps;         // Number of solver decisions made
+    long moves;         // Number of cells moved forward
+    long turns;         // Number of left and right turns
+    long cellsVisited;  // Number of distinct cells the mouse entered, including the start cell
+    int reachedGoal;    // 1 if the mouse reached a goal cell
+    int crashed;        // 1 if the mouse attempted to move through a wall
+    double elapsed;     // Wall-clock time spent in the run (seconds)
+    double runTime;     // Simulated time the mouse's body took, ending at rest (seconds), 0 if not timed
+    long memoryUsed;    // Most memory the solver held from its arena (bytes)
+    long allocations;   // Number of arena allocations the solver made
+    int overBudget;     // 1 if the solver tried to allocate beyond its memory budget
+} SimStats;
+
+// Everything one simulation needs apart from the maze, which may be shared read-only between contexts
+typedef struct
+{
+    Mouse mouse;
+    SolverState state;
+    MotionState motion;
+} SimContext;
+
+// Start position and heading of a run
+typedef struct
+{
+    int x, y;
+    Heading heading;
+} StartConfig;
+
+void initContext(SimContext *context, Maze *maze, int solver);
+void enableMotion(SimContext *context, const MotionProfile *profile);
+void startRun(SimContext *context, StartConfig start);
+void freeContext(SimContext *context);
+int getCornerStarts(int size, StartConfig starts[8]);
+int simulate(Mouse *mouse, long maxSteps, SimStats *stats);
+double getTime();
+
+#endif
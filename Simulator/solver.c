@@ -1,12 +1,84 @@
+#include <stdlib.h>
+#include <string.h>
 #include "solver.h"
 #include "mouse.h"
 
+// Maze solving algorithms built into the simulator; the first entry is used by default
+static SolverEntry builtinSolvers[] = {
+    {"leftWallFollower", leftWallFollower},
+    {"obstacleAvoider", obstacleAvoider},
+    {"floodFill", floodFill},
+};
 
-// This function redirects function calls from mouse.c to the desired maze solving algorithm
+// Registered maze solving algorithms: the built-in ones followed by any loaded from plugins
+SolverEntry *solvers = builtinSolvers;
+int solverCount = sizeof(builtinSolvers) / sizeof(builtinSolvers[0]);
+
+// This function redirects function calls from mouse.c to the mouse's maze solving algorithm
 Action solver(Mouse *mouse)
 {
-    // This can be changed to call other maze solving algorithms
-    return leftWallFollower(mouse);
+    return solvers[mouse->solver].solve(mouse);
+}
+
+// Returns the index of the solver with the given name in the solvers table, or -1 if there is none
+int findSolver(const char *name)
+{
+    for(int i = 0; i < solverCount; i++)
+    {
+        if(!strcmp(solvers[i].name, name)) return i;
+    }
+
+    return -1;
+}
+
+// Adds a solver to the solvers table; solvers must not be registered while simulations are running
+// Returns the index of the new solver, or -1 if the name is taken or memory could not be allocated
+int registerSolver(const char *name, Action (*solve)(Mouse *mouse), struct LoadedPlugin *plugin)
+{
+    if(findSolver(name) >= 0) return -1;
+
+    SolverEntry *table = malloc(sizeof(SolverEntry) * (solverCount + 1));
+    if(!table) return -1;
+    memcpy(table, solvers, sizeof(SolverEntry) * solverCount);
+    if(solvers != builtinSolvers) free(solvers);
+
+    table[solverCount].name = name;
+    table[solverCount].solve = solve;
+    table[solverCount].plugin = plugin;
+    solvers = table;
+    return solverCount++;
+}
+
+// Clears the state kept by the mouse's solving algorithm so a new run can begin
+// The arena's memory is kept for reuse by the next run
+void resetSolver(Mouse *mouse)
+{
+    SolverState *state = mouse->state;
+    resetArena(&state->arena);
+    state->turnedLeft = 0;
+    state->floodReady = 0;
+    state->floodFillUpdates = 0;
+    resetPluginInstance(mouse);
+}
+
+// Frees buffers allocated by the solving algorithms
+void freeSolverState(SolverState *state)
+{
+    freeArena(&state->arena);
+    state->floodMaze = (Maze) {0};
+    state->floodDistances = NULL;
+    state->floodQueue = NULL;
+    state->floodQueued = NULL;
+    state->floodReady = 0;
+    freePluginInstance(state);
+}
+
+// Caps the memory the solving algorithms may allocate in a run (bytes, 0 for no limit), freeing their buffers
+// Plugin solvers manage their own memory, which does not count against the budget
+void setSolverBudget(SolverState *state, size_t budget)
+{
+    freeSolverState(state);
+    initArena(&state->arena, budget);
 }
 
 // Simple algorithm; mouse goes straight until encountering a wall, then preferentially turns left
@@ -19,25 +91,174 @@ Action obstacleAvoider(Mouse *mouse)
 }
 
 // Left wall following algorithm
-int turnedLeft = 0;
 Action leftWallFollower(Mouse *mouse)
 {
-    if(turnedLeft)
+    SolverState *state = mouse->state;
+    if(state->turnedLeft)
     {
-        turnedLeft = 0;
+        state->turnedLeft = 0;
         return FORWARD;
     }
     else if(getLeftReading(mouse) == 0)
     {
-        turnedLeft = 1;
+        state->turnedLeft = 1;
         return LEFT;
     }
     else if(getFrontReading(mouse) == 0) return FORWARD;
     else return RIGHT;
 }
 
+// Offsets of the neighboring cell in each heading
+static const int dx[4] = {0, 1, 0, -1};
+static const int dy[4] = {1, 0, -1, 0};
+
+// Starts flood fill on an empty maze of the given size: only border walls are known and distances are
+// computed with a full breadth-first flood from the goal cells
+// Returns 1 on success, 0 if memory could not be allocated (or would go over the solver's memory budget)
+static int initFloodFill(SolverState *s, int size)
+{
+    int cells = size * size;
+
+    void *walls = arenaAlloc(&s->arena, getMazeStorageSize(size));
+    s->floodDistances = arenaAlloc(&s->arena, sizeof(int) * cells);
+    s->floodQueue = arenaAlloc(&s->arena, sizeof(int) * cells);
+    s->floodQueued = arenaAlloc(&s->arena, cells);
+    if(!walls || !s->floodDistances || !s->floodQueue || !s->floodQueued) return 0;
+    initMazeIn(&s->floodMaze, size, walls);
+
+    int *floodDistances = s->floodDistances;
+    int *floodQueue = s->floodQueue;
+    Maze *floodMaze = &s->floodMaze;
+
+    memset(s->floodQueued, 0, cells);
+    int head = 0, tail = 0;
+    for(int i = 0; i < cells; i++)
+    {
+        if(isGoal(floodMaze, i % size, i / size))
+        {
+            floodDistances[i] = 0;
+            floodQueue[tail++] = i;
+        }
+        else floodDistances[i] = cells;
+    }
+
+    while(head < tail)
+    {
+        int cell = floodQueue[head++];
+        int x = cell % size, y = cell / size;
+        for(int d = 0; d < 4; d++)
+        {
+            if(hasWall(floodMaze, x, y, d)) continue;
+            int next = cell + dy[d] * size + dx[d];
+            if(floodDistances[next] > floodDistances[cell] + 1)
+            {
+                floodDistances[next] = floodDistances[cell] + 1;
+                floodQueue[tail++] = next;
+            }
+        }
+    }
+
+    s->floodReady = 1;
+    return 1;
+}
+
+// Queues a cell for re-flooding unless it is already queued
+static void queueCell(SolverState *s, int cell, int *tail, int cells)
+{
+    if(s->floodQueued[cell]) return;
+    s->floodQueued[cell] = 1;
+    s->floodQueue[*tail] = cell;
+    *tail = (*tail + 1) % cells;
+}
+
+// Records a sensed wall and queues both cells next to it if the wall was not already known
+static void addWall(SolverState *s, int x, int y, int direction, int *tail)
+{
+    int size = s->floodMaze.size;
+    if(hasWall(&s->floodMaze, x, y, direction)) return;
+
+    setWall(&s->floodMaze, x, y, direction, 1);
+    queueCell(s, y * size + x, tail, size * size);
+    queueCell(s, (y + dy[direction]) * size + x + dx[direction], tail, size * size);
+}
+
+// Modified flood fill: a queued cell whose distance no longer equals one more than its lowest open neighbor
+// gets corrected and its open neighbors get re-checked, so only cells whose distance changes are touched
+// Distances are capped at the number of cells so regions walled off from the goal settle instead of counting up
+static void reflood(SolverState *s, int head, int tail)
+{
+    int size = s->floodMaze.size;
+    int cells = size * size;
+    int *floodDistances = s->floodDistances;
+
+    while(head != tail)
+    {
+        int cell = s->floodQueue[head];
+        head = (head + 1) % cells;
+        s->floodQueued[cell] = 0;
+
+        int x = cell % size, y = cell / size;
+        if(isGoal(&s->floodMaze, x, y)) continue;
+
+        int lowest = cells;
+        for(int d = 0; d < 4; d++)
+        {
+            if(hasWall(&s->floodMaze, x, y, d)) continue;
+            int next = cell + dy[d] * size + dx[d];
+            if(floodDistances[next] < lowest) lowest = floodDistances[next];
+        }
+
+        int distance = (lowest + 1 < cells) ? lowest + 1 : cells;
+        if(distance == floodDistances[cell]) continue;
+
+        floodDistances[cell] = distance;
+        s->floodFillUpdates++;
+
+        for(int d = 0; d < 4; d++)
+        {
+            if(!hasWall(&s->floodMaze, x, y, d)) queueCell(s, cell + dy[d] * size + dx[d], &tail, cells);
+        }
+    }
+}
+
+// Flood fill algorithm; keeps a map of discovered walls and each cell's distance to the goal, re-flooding only
+// the affected cells when a new wall is sensed, and always moves toward the open neighbor closest to the goal
 Action floodFill(Mouse *mouse)
 {
-    // TODO: Implement this function!
-    return IDLE;
+    SolverState *s = mouse->state;
+    if(!s->floodReady || s->floodMaze.size != mouse->maze->size)
+    {
+        if(!initFloodFill(s, mouse->maze->size)) return IDLE;
+    }
+
+    int x = mouse->x, y = mouse->y, heading = mouse->heading;
+    int size = s->floodMaze.size;
+    if(isGoal(&s->floodMaze, x, y)) return IDLE;
+
+    // Record sensor readings in the wall map and re-flood around any new walls
+    int tail = 0;
+    if(getLeftReading(mouse)) addWall(s, x, y, (heading + 3) % 4, &tail);
+    if(getFrontReading(mouse)) addWall(s, x, y, heading, &tail);
+    if(getRightReading(mouse)) addWall(s, x, y, (heading + 1) % 4, &tail);
+    reflood(s, 0, tail);
+
+    // Pick the open neighbor with the lowest distance, preferring forward, then right, left and back
+    static const int preference[4] = {0, 1, 3, 2};
+    int best = -1, bestDistance = 0;
+    for(int i = 0; i < 4; i++)
+    {
+        int d = (heading + preference[i]) % 4;
+        if(hasWall(&s->floodMaze, x, y, d)) continue;
+        int distance = s->floodDistances[(y + dy[d]) * size + x + dx[d]];
+        if(best < 0 || distance < bestDistance)
+        {
+            best = d;
+            bestDistance = distance;
+        }
+    }
+
+    if(best < 0) return IDLE;
+    if(best == heading) return FORWARD;
+    if(best == (heading + 3) % 4) return LEFT;
+    return RIGHT;
 }
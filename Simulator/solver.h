@@ -2,8 +2,64 @@
 #define SOLVER_H
 
 #include "mouse.h"
+#include "arena.h"
+
+// Solver plugin loaded from a shared object; defined in plugin.c
+struct LoadedPlugin;
+
+// Maze solving algorithm that can be selected by name
+typedef struct
+{
+    const char *name;
+    Action (*solve)(Mouse *mouse);
+    struct LoadedPlugin *plugin;        // Plugin providing the solver, NULL for solvers built into the simulator
+} SolverEntry;
+
+// State kept by the solving algorithms between decisions; every mouse has its own so that any number of
+// simulations can run at once. Solvers reach it through mouse->state
+// Memory a solver needs for a run comes from the arena, which is reset with the solver, so it counts against
+// the arena's budget
+typedef struct SolverState
+{
+    Arena arena;
+
+    // Left wall follower
+    int turnedLeft;
+
+    // Flood fill: walls discovered so far, distance to goal of every cell and the queue used to re-flood, all
+    // allocated from the arena
+    Maze floodMaze;
+    int *floodDistances;
+    int *floodQueue;
+    char *floodQueued;
+    int floodReady;
+    unsigned long floodFillUpdates;     // Number of cell distance updates made since the last reset
+
+    // Plugin solvers: the instance created by the plugin for this mouse
+    void *pluginInstance;
+    int pluginReady;                    // 1 if pluginInstance has been created
+    int pluginSolver;                   // Index of the solver that created pluginInstance
+    int pluginMazeSize;                 // Maze size pluginInstance was created for
+} SolverState;
+
+extern SolverEntry *solvers;
+extern int solverCount;
 
 Action solver(Mouse *mouse);
+int findSolver(const char *name);
+int registerSolver(const char *name, Action (*solve)(Mouse *mouse), struct LoadedPlugin *plugin);
+void resetSolver(Mouse *mouse);
+void freeSolverState(SolverState *state);
+void setSolverBudget(SolverState *state, size_t budget);
+
+// Solver plugins (plugin.c)
+int loadSolverPlugin(const char *path);
+int findOrLoadSolver(const char *name);
+int reloadSolverPlugins(Mouse *mice, int count);
+Action pluginSolver(Mouse *mouse);
+void resetPluginInstance(Mouse *mouse);
+void freePluginInstance(SolverState *state);
+Action obstacleAvoider(Mouse *mouse);
 Action leftWallFollower(Mouse *mouse);
 Action floodFill(Mouse *mouse);
 
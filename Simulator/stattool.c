@@ -0,0 +1,217 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "maze.h"
+#include "pack.h"
+#include "analysis.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazeDirectory = "../Mazes/";  // Path to maze folder
+char *packPath = NULL;              // Pack file to take mazes from instead of the maze folder
+int threads = 0;                    // Number of worker threads, 0 to use one per core
+int summaryOnly = 0;                // 1 to print only corpus totals
+
+// Output formats
+typedef enum Format {TABLE, CSV, JSON} Format;
+Format format = TABLE;
+
+void printStats(const char *name, const MazeStats *s, int last);
+void printSummary(const MazeStats *stats, long count, double elapsed);
+void printUsage(const char *program);
+
+// MAIN
+// Analyzes the structure of every maze in the maze folder or a pack on all cores and prints one line per maze
+int main(int argc, char** argv)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--dir") && i + 1 < argc) mazeDirectory = argv[++i];
+        else if(!strcmp(argv[i], "--pack") && i + 1 < argc) packPath = argv[++i];
+        else if(!strcmp(argv[i], "--threads") && i + 1 < argc) threads = atoi(argv[++i]);
+        else if(!strcmp(argv[i], "--summary")) summaryOnly = 1;
+        else if(!strcmp(argv[i], "--csv")) format = CSV;
+        else if(!strcmp(argv[i], "--json")) format = JSON;
+        else
+        {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+    if(threads < 0)
+    {
+        printf("Error: thread count must not be negative\n");
+        return -1;
+    }
+    if(threads == 0)
+    {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? cores : 1;
+    }
+
+    // Maze paths are appended to the folder path, so make sure it ends with a separator
+    size_t length = strlen(mazeDirectory);
+    if(length && mazeDirectory[length - 1] != '/')
+    {
+        char *directory = malloc(length + 2);
+        sprintf(directory, "%s/", mazeDirectory);
+        mazeDirectory = directory;
+    }
+
+    // Load every maze up front, or leave pack mazes for the workers to decode as they go
+    Maze *mazes = NULL;
+    char **names = NULL;
+    MazePack pack = {0};
+    int loaded;
+    if(packPath)
+    {
+        if(!openPack(&pack, packPath)) return -1;
+        loaded = pack.count;
+    }
+    else
+    {
+        loaded = loadMazes(&mazes, &names);
+        if(loaded <= 0)
+        {
+            printf("Error: no valid maze files found in %s\n", mazeDirectory);
+            return -1;
+        }
+    }
+
+    MazeStats *stats = malloc(sizeof(MazeStats) * (loaded > 0 ? loaded : 1));
+    if(!stats)
+    {
+        printf("Error: unable to allocate results for %d mazes\n", loaded);
+        return -1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int status = analyzeMazes(mazes, packPath ? &pack : NULL, stats, loaded, threads) ? 0 : -1;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+    if(status) printf("Error: unable to start analysis\n");
+
+    // Report results in maze order
+    if(!status && !summaryOnly)
+    {
+        if(format == TABLE)
+        {
+            printf("%-24s %5s %6s %6s %6s %6s %8s %10s %7s %7s %7s %7s %7s\n", "maze", "size", "cells", "dead",
+                   "forks", "loops", "shortest", "paths", "branch", "left", "l-cells", "right", "r-cells");
+        }
+        else if(format == CSV)
+        {
+            printf("maze,size,reachable,dead_ends,junctions,loops,shortest,shortest_paths,branching,left_wall_moves,"
+                   "left_wall_cells,right_wall_moves,right_wall_cells\n");
+        }
+        else printf("[\n");
+
+        for(int m = 0; m < loaded; m++)
+        {
+            if(!stats[m].size) continue;
+            const char *name = names ? names[m] : pack.entries[m].file[0] ? pack.entries[m].file : pack.entries[m].name;
+            printStats(name, &stats[m], m == loaded - 1);
+        }
+        if(format == JSON) printf("]\n");
+    }
+    if(!status && (summaryOnly || format == TABLE)) printSummary(stats, loaded, elapsed);
+
+    if(packPath) closePack(&pack);
+    else
+    {
+        for(int m = 0; m < loaded; m++)
+        {
+            freeMaze(&mazes[m]);
+            free(names[m]);
+        }
+        free(names);
+        free(mazes);
+    }
+    free(stats);
+    return status;
+}
+
+// Prints one maze's results as a table row, CSV line or JSON object; distances the goal or wall followers never
+// reach are printed as - in tables, -1 in CSV and null in JSON
+void printStats(const char *name, const MazeStats *s, int last)
+{
+    if(format == TABLE)
+    {
+        char shortest[16] = "-", left[16] = "-", right[16] = "-";
+        if(s->shortest >= 0) snprintf(shortest, sizeof(shortest), "%d", s->shortest);
+        if(s->leftWallMoves >= 0) snprintf(left, sizeof(left), "%d", s->leftWallMoves);
+        if(s->rightWallMoves >= 0) snprintf(right, sizeof(right), "%d", s->rightWallMoves);
+        printf("%-24s %5d %6d %6d %6d %6d %8s %10.4g %7.3f %7s %7d %7s %7d\n", name, s->size, s->reachable,
+               s->deadEnds, s->junctions, s->loops, shortest, s->shortestPaths, s->branching, left, s->leftWallCells,
+               right, s->rightWallCells);
+    }
+    else if(format == CSV)
+    {
+        printf("%s,%d,%d,%d,%d,%d,%d,%.17g,%.6f,%d,%d,%d,%d\n", name, s->size, s->reachable, s->deadEnds,
+               s->junctions, s->loops, s->shortest, s->shortestPaths, s->branching, s->leftWallMoves,
+               s->leftWallCells, s->rightWallMoves, s->rightWallCells);
+    }
+    else
+    {
+        char shortest[16] = "null", left[16] = "null", right[16] = "null";
+        if(s->shortest >= 0) snprintf(shortest, sizeof(shortest), "%d", s->shortest);
+        if(s->leftWallMoves >= 0) snprintf(left, sizeof(left), "%d", s->leftWallMoves);
+        if(s->rightWallMoves >= 0) snprintf(right, sizeof(right), "%d", s->rightWallMoves);
+        printf("  {\"maze\": \"%s\", \"size\": %d, \"reachable\": %d, \"dead_ends\": %d, \"junctions\": %d, "
+               "\"loops\": %d, \"shortest\": %s, \"shortest_paths\": %.17g, \"branching\": %.6f, "
+               "\"left_wall_moves\": %s, \"left_wall_cells\": %d, \"right_wall_moves\": %s, "
+               "\"right_wall_cells\": %d}%s\n", name, s->size, s->reachable, s->deadEnds, s->junctions, s->loops,
+               shortest, s->shortestPaths, s->branching, left, s->leftWallCells, right, s->rightWallCells,
+               last ? "" : ",");
+    }
+}
+
+// Prints totals over the whole corpus
+void printSummary(const MazeStats *stats, long count, double elapsed)
+{
+    long analyzed = 0, unsolvable = 0, perfect = 0, leftGoals = 0, rightGoals = 0;
+    double deadEnds = 0, loops = 0, shortest = 0;
+    for(long m = 0; m < count; m++)
+    {
+        const MazeStats *s = &stats[m];
+        if(!s->size) continue;
+        analyzed++;
+        deadEnds += s->deadEnds;
+        loops += s->loops;
+        if(s->shortest < 0) unsolvable++;
+        else shortest += s->shortest;
+        perfect += !s->loops;
+        leftGoals += s->leftWallMoves >= 0;
+        rightGoals += s->rightWallMoves >= 0;
+    }
+
+    if(format == TABLE && !summaryOnly) printf("\n");
+    printf("Mazes: %ld (%ld could not be analyzed)\n", analyzed, count - analyzed);
+    if(analyzed)
+    {
+        printf("Goal unreachable: %ld\n", unsolvable);
+        printf("Without loops: %ld\n", perfect);
+        printf("Mean dead ends: %.2f, loops: %.2f", deadEnds / analyzed, loops / analyzed);
+        if(analyzed > unsolvable) printf(", shortest path: %.2f", shortest / (analyzed - unsolvable));
+        printf("\n");
+        printf("Solved by wall following: %ld left, %ld right\n", leftGoals, rightGoals);
+    }
+    printf("Threads: %d\n", threads);
+    printf("Elapsed: %.6f s\n", elapsed);
+    if(elapsed > 0) printf("Throughput: %.0f mazes/s\n", analyzed / elapsed);
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--dir PATH | --pack FILE] [--threads N] [--summary] [--csv | --json]\n", program);
+    printf("  --dir PATH     folder of maze files to analyze (default ../Mazes/)\n");
+    printf("  --pack FILE    analyze the mazes in this pack file instead of a folder\n");
+    printf("  --threads N    worker threads (default: one per core)\n");
+    printf("  --summary      only print totals over all mazes\n");
+    printf("  --csv          print results as CSV\n");
+    printf("  --json         print results as JSON\n");
+}
@@ -0,0 +1,283 @@
+#include <stdlib.h>
+#include <string.h>
+#include "symmetry.h"
+
+// Symmetries on bitboards
+// Walls are compared in a normalized form: the maze's north and east wall bitsets with the border walls (the
+// north walls of the top row and the east walls of the last column) cleared, since every maze has them. On that
+// form each symmetry is a few whole-row operations for mazes up to 64 cells wide: mirroring east-west reverses
+// the bits of every row, mirroring north-south reverses the order of the rows, and swapping x and y transposes
+// both bitboards and exchanges them, as the north wall of (x, y) is the east wall of (y, x). Wider mazes are
+// transformed one wall at a time.
+
+const char *symmetryNames[SYMMETRY_COUNT] = {"identity", "mirror-x", "mirror-y", "rotate-180", "transpose",
+                                             "rotate-90", "rotate-270", "anti-transpose"};
+
+// Moves cell (x, y) to where the symmetry puts it
+void transformCell(int size, int symmetry, int *x, int *y)
+{
+    if(symmetry & SYMMETRY_TRANSPOSE)
+    {
+        int swap = *x;
+        *x = *y;
+        *y = swap;
+    }
+    if(symmetry & SYMMETRY_MIRROR_X) *x = size - 1 - *x;
+    if(symmetry & SYMMETRY_MIRROR_Y) *y = size - 1 - *y;
+}
+
+// Returns the heading (NORTH, EAST, SOUTH or WEST) that the symmetry turns the given heading into
+int transformHeading(int symmetry, int heading)
+{
+    if(symmetry & SYMMETRY_TRANSPOSE) heading = (5 - heading) & 3;     // North and east swap, as do south and west
+    if(symmetry & SYMMETRY_MIRROR_X) heading = (4 - heading) & 3;      // East and west swap
+    if(symmetry & SYMMETRY_MIRROR_Y) heading = (6 - heading) & 3;      // North and south swap
+    return heading;
+}
+
+// Reverses the lowest size bits of a row
+static inline uint64_t reverseRow(uint64_t row, int size)
+{
+    row = __builtin_bswap64(row);
+    row = ((row >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((row & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    row = ((row >> 2) & 0x3333333333333333ULL) | ((row & 0x3333333333333333ULL) << 2);
+    row = ((row >> 1) & 0x5555555555555555ULL) | ((row & 0x5555555555555555ULL) << 1);
+    return row >> (64 - size);
+}
+
+// Transposes a bitboard of size rows in place, so bit x of row y moves to bit y of row x; the rows array must
+// have room for size rounded up to a power of two. Swaps ever smaller blocks along the diagonal, log2 steps
+static void transposeRows(uint64_t *rows, int size)
+{
+    int n = 1;
+    while(n < size) n <<= 1;
+    for(int y = size; y < n; y++) rows[y] = 0;
+
+    static const uint64_t masks[6] = {0x5555555555555555ULL, 0x3333333333333333ULL, 0x0F0F0F0F0F0F0F0FULL,
+                                      0x00FF00FF00FF00FFULL, 0x0000FFFF0000FFFFULL, 0x00000000FFFFFFFFULL};
+    for(int level = 5, j = 32; j >= 1; level--, j >>= 1)
+    {
+        if(j >= n) continue;
+        for(int k = 0; k < n; k++)
+        {
+            if(k & j) continue;
+            uint64_t t = ((rows[k] >> j) ^ rows[k + j]) & masks[level];
+            rows[k] ^= t << j;
+            rows[k + j] ^= t;
+        }
+    }
+}
+
+// Loads the normalized walls of a maze up to 64 cells wide
+static void loadRows(const Maze *maze, uint64_t *north, uint64_t *east)
+{
+    int size = maze->size;
+    uint64_t mask = (size == 64) ? ~0ULL : (1ULL << size) - 1;
+    uint64_t border = 1ULL << (size - 1);
+    for(int y = 0; y < size; y++)
+    {
+        north[y] = maze->northWalls[y] & mask;
+        east[y] = maze->eastWalls[y] & mask & ~border;
+    }
+    north[size - 1] = 0;
+}
+
+// Applies the mirror flags of a symmetry to normalized walls up to 64 cells wide; the swap of x and y must
+// already have been applied
+static void mirrorRows(const uint64_t *north, const uint64_t *east, int size, int symmetry, uint64_t *outNorth,
+                       uint64_t *outEast)
+{
+    for(int y = 0; y < size; y++)
+    {
+        // Mirroring north-south moves row y's east walls to row size - 1 - y, and the north walls of row y
+        // (between rows y and y + 1) to row size - 2 - y
+        int eastRow = (symmetry & SYMMETRY_MIRROR_Y) ? size - 1 - y : y;
+        int northRow = (symmetry & SYMMETRY_MIRROR_Y) ? size - 2 - y : y;
+        uint64_t n = northRow >= 0 ? north[northRow] : 0;
+        uint64_t e = east[eastRow];
+
+        // Mirroring east-west moves the east wall of x to the east wall of size - 2 - x
+        if(symmetry & SYMMETRY_MIRROR_X)
+        {
+            n = reverseRow(n, size);
+            e = reverseRow(e, size) >> 1;
+        }
+        outNorth[y] = n;
+        outEast[y] = e;
+    }
+}
+
+// Wider mazes: moves every interior wall to where the symmetry puts it
+static void transformWide(const Maze *maze, int symmetry, uint64_t *north, uint64_t *east)
+{
+    int size = maze->size, rowWords = maze->rowWords;
+    memset(north, 0, sizeof(uint64_t) * size * rowWords);
+    memset(east, 0, sizeof(uint64_t) * size * rowWords);
+
+    for(int y = 0; y < size; y++)
+    {
+        for(int x = 0; x < size; x++)
+        {
+            for(int direction = 0; direction < 2; direction++)
+            {
+                // Cells on both sides of the north (direction 0) or east (direction 1) wall of (x, y)
+                int ax = x, ay = y, bx = x + direction, by = y + 1 - direction;
+                if(bx >= size || by >= size) continue;
+                const uint64_t *walls = direction ? maze->eastWalls : maze->northWalls;
+                if(!((walls[y * rowWords + (x >> 6)] >> (x & 63)) & 1)) continue;
+
+                transformCell(size, symmetry, &ax, &ay);
+                transformCell(size, symmetry, &bx, &by);
+                uint64_t *row = (ax == bx) ? north : east;
+                int wx = ax < bx ? ax : bx, wy = ay < by ? ay : by;
+                row[wy * rowWords + (wx >> 6)] |= 1ULL << (wx & 63);
+            }
+        }
+    }
+}
+
+// Writes the normalized walls of the maze as transformed by the symmetry: north and east receive size rows of
+// the maze's rowWords words each, with border walls cleared
+void transformWalls(const Maze *maze, int symmetry, uint64_t *north, uint64_t *east)
+{
+    int size = maze->size;
+    if(size > 64)
+    {
+        transformWide(maze, symmetry, north, east);
+        return;
+    }
+
+    uint64_t n[64], e[64];
+    loadRows(maze, n, e);
+    if(symmetry & SYMMETRY_TRANSPOSE)
+    {
+        transposeRows(n, size);
+        transposeRows(e, size);
+        mirrorRows(e, n, size, symmetry, north, east);
+    }
+    else mirrorRows(n, e, size, symmetry, north, east);
+}
+
+// Writes the maze as transformed by the symmetry into out, reusing its wall storage when it is already the
+// right size
+// Returns 1 on success, 0 if memory could not be allocated
+int transformMaze(const Maze *maze, int symmetry, Maze *out)
+{
+    int size = maze->size;
+#ifndef HEADLESS
+    out->mazeTexture = NULL;
+#endif
+    if(out->size != size && !clearMaze(out, size)) return 0;
+    memcpy(out->name, maze->name, sizeof(out->name));
+
+    // Put the border walls back, then derive the cell wall masks from the bitsets
+    int rowWords = out->rowWords;
+    transformWalls(maze, symmetry, out->northWalls, out->eastWalls);
+    uint64_t lastMask = (size & 63) ? (1ULL << (size & 63)) - 1 : ~0ULL;
+    for(int w = 0; w < rowWords; w++)
+    {
+        out->northWalls[(size - 1) * rowWords + w] = (w == rowWords - 1) ? lastMask : ~0ULL;
+    }
+    for(int y = 0; y < size; y++) out->eastWalls[y * rowWords + ((size - 1) >> 6)] |= 1ULL << ((size - 1) & 63);
+    updateCellWalls(out);
+    return 1;
+}
+
+static inline uint64_t mixHash(uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    return h ^ (h >> 31);
+}
+
+// Hashes normalized walls of the given size
+uint64_t hashWalls(const uint64_t *north, const uint64_t *east, int size, int rowWords)
+{
+    uint64_t h = mixHash(size);
+    for(size_t i = 0; i < (size_t) size * rowWords; i++)
+    {
+        h = mixHash(h ^ north[i]);
+        h = mixHash(h + east[i]);
+    }
+    return h;
+}
+
+// Returns a hash of the maze's walls that is the same for all 8 of its rotations and reflections: the smallest
+// hash of any of them. If symmetry is given, it receives the symmetry that gave the smallest hash
+// Returns 0 if memory could not be allocated
+uint64_t getCanonicalHash(const Maze *maze, int *symmetry)
+{
+    int size = maze->size, rowWords = maze->rowWords;
+    uint64_t best = ~0ULL;
+    int bestSymmetry = 0;
+
+    if(size <= 64)
+    {
+        // The transpose is shared by the four symmetries that swap x and y
+        uint64_t n[64], e[64], tn[64], te[64], outNorth[64], outEast[64];
+        loadRows(maze, n, e);
+        memcpy(tn, e, sizeof(uint64_t) * size);
+        memcpy(te, n, sizeof(uint64_t) * size);
+        transposeRows(tn, size);
+        transposeRows(te, size);
+        for(int s = 0; s < SYMMETRY_COUNT; s++)
+        {
+            if(s & SYMMETRY_TRANSPOSE) mirrorRows(tn, te, size, s, outNorth, outEast);
+            else mirrorRows(n, e, size, s, outNorth, outEast);
+            uint64_t h = hashWalls(outNorth, outEast, size, 1);
+            if(h < best)
+            {
+                best = h;
+                bestSymmetry = s;
+            }
+        }
+    }
+    else
+    {
+        uint64_t *north = malloc(sizeof(uint64_t) * 2 * size * rowWords);
+        if(!north) return 0;
+        uint64_t *east = north + (size_t) size * rowWords;
+        for(int s = 0; s < SYMMETRY_COUNT; s++)
+        {
+            transformWide(maze, s, north, east);
+            uint64_t h = hashWalls(north, east, size, rowWords);
+            if(h < best)
+            {
+                best = h;
+                bestSymmetry = s;
+            }
+        }
+        free(north);
+    }
+
+    if(symmetry) *symmetry = bestSymmetry;
+    return best;
+}
+
+// Returns the first symmetry that turns maze a into maze b, or -1 if b is not a rotation or reflection of a (or
+// memory could not be allocated)
+int findSymmetry(const Maze *a, const Maze *b)
+{
+    if(a->size != b->size) return -1;
+    size_t words = (size_t) a->size * a->rowWords;
+    uint64_t *memory = malloc(sizeof(uint64_t) * 4 * words);
+    if(!memory) return -1;
+    uint64_t *targetNorth = memory, *targetEast = memory + words;
+    uint64_t *north = memory + 2 * words, *east = memory + 3 * words;
+
+    int found = -1;
+    transformWalls(b, 0, targetNorth, targetEast);
+    for(int s = 0; s < SYMMETRY_COUNT && found < 0; s++)
+    {
+        transformWalls(a, s, north, east);
+        if(!memcmp(north, targetNorth, sizeof(uint64_t) * words) && !memcmp(east, targetEast, sizeof(uint64_t) * words))
+        {
+            found = s;
+        }
+    }
+
+    free(memory);
+    return found;
+}
@@ -0,0 +1,25 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <stdint.h>
+#include "maze.h"
+
+// The 8 symmetries of a square maze (rotations and reflections), numbered by three flags applied in this
+// order: swap x and y, then mirror east-west, then mirror north-south. 0 is the identity; rotations are
+// counterclockwise
+#define SYMMETRY_COUNT 8
+#define SYMMETRY_MIRROR_X 1
+#define SYMMETRY_MIRROR_Y 2
+#define SYMMETRY_TRANSPOSE 4
+
+extern const char *symmetryNames[SYMMETRY_COUNT];
+
+void transformCell(int size, int symmetry, int *x, int *y);
+int transformHeading(int symmetry, int heading);
+void transformWalls(const Maze *maze, int symmetry, uint64_t *north, uint64_t *east);
+int transformMaze(const Maze *maze, int symmetry, Maze *out);
+uint64_t hashWalls(const uint64_t *north, const uint64_t *east, int size, int rowWords);
+uint64_t getCanonicalHash(const Maze *maze, int *symmetry);
+int findSymmetry(const Maze *a, const Maze *b);
+
+#endif
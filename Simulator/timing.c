@@ -0,0 +1,149 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "timing.h"
+
+#define MAX_FRAME_INTERVAL 1000000000ULL    // Longest gap counted as a frame; longer ones are pauses (nanoseconds)
+
+// Latest samples of one stage, oldest overwritten first (microseconds)
+typedef struct
+{
+    float samples[TIMING_WINDOW];
+    int count;
+    int next;
+} TimingSeries;
+
+int timingEnabled = 0;              // 1 to time stages, set while the timing overlay or a timing trace is on
+const char *timingStageNames[STAGE_COUNT] = {"frame", "simulate", "solver", "maze", "mouse", "hud", "present"};
+
+static TimingSeries series[STAGE_COUNT];
+static uint64_t lastFrame = 0;      // Time the last frame started, 0 if it was not timed (nanoseconds)
+
+// Chrome trace event output; solver decisions are too many to write one by one, so they are summed per frame
+// and written as a counter
+static FILE *traceFile = NULL;
+static uint64_t traceStart = 0;     // Time the trace was started (nanoseconds)
+static int traceEvents = 0;         // Events written so far
+static uint64_t frameSolverTime = 0;// Time spent in solver decisions in the current frame (nanoseconds)
+static long frameDecisions = 0;     // Solver decisions made in the current frame
+
+// Writes one trace event; times are in microseconds since the trace was started
+static void writeTraceEvent(const char *name, const char *phase, uint64_t start, uint64_t duration, const char *args)
+{
+    fprintf(traceFile, "%s\n{\"name\": \"%s\", \"cat\": \"simulator\", \"ph\": \"%s\", \"ts\": %.3f, ",
+            traceEvents++ ? "," : "", name, phase, (start - traceStart) * 1e-3);
+    if(phase[0] == 'X') fprintf(traceFile, "\"dur\": %.3f, ", duration * 1e-3);
+    fprintf(traceFile, "\"pid\": 1, \"tid\": 1%s%s}", args ? ", \"args\": " : "", args ? args : "");
+}
+
+// Records the time a stage took from the given start; does nothing if the start is 0 (timing was off)
+void endTiming(TimingStage stage, uint64_t start)
+{
+    if(!start) return;
+    uint64_t end = getTimingClock();
+
+    TimingSeries *s = &series[stage];
+    s->samples[s->next] = (end - start) * 1e-3f;
+    s->next = (s->next + 1) % TIMING_WINDOW;
+    if(s->count < TIMING_WINDOW) s->count++;
+
+    if(!traceFile) return;
+    if(stage == STAGE_SOLVER)
+    {
+        frameSolverTime += end - start;
+        frameDecisions++;
+    }
+    else writeTraceEvent(timingStageNames[stage], "X", start, end - start, NULL);
+}
+
+// Marks the start of a frame, recording the time since the last one; gaps of over a second are pauses and are
+// not counted
+void markFrame()
+{
+    uint64_t now = timingEnabled ? getTimingClock() : 0;
+    if(now && lastFrame && now - lastFrame < MAX_FRAME_INTERVAL)
+    {
+        TimingSeries *s = &series[STAGE_FRAME];
+        s->samples[s->next] = (now - lastFrame) * 1e-3f;
+        s->next = (s->next + 1) % TIMING_WINDOW;
+        if(s->count < TIMING_WINDOW) s->count++;
+
+        if(traceFile)
+        {
+            char args[96];
+            writeTraceEvent("frame", "X", lastFrame, now - lastFrame, NULL);
+            snprintf(args, sizeof(args), "{\"decisions\": %ld, \"us_per_decision\": %.3f}", frameDecisions,
+                     frameDecisions ? frameSolverTime * 1e-3 / frameDecisions : 0.0);
+            writeTraceEvent("solver", "C", lastFrame, 0, args);
+        }
+    }
+    frameSolverTime = 0;
+    frameDecisions = 0;
+    lastFrame = now;
+}
+
+static int compareSamples(const void *a, const void *b)
+{
+    float x = *(const float *) a, y = *(const float *) b;
+    return (x > y) - (x < y);
+}
+
+// Computes the minimum, mean and 99th percentile of a stage's latest samples
+void summarizeTiming(TimingStage stage, TimingSummary *summary)
+{
+    const TimingSeries *s = &series[stage];
+    *summary = (TimingSummary) {s->count};
+    if(!s->count) return;
+
+    float sorted[TIMING_WINDOW];
+    memcpy(sorted, s->samples, sizeof(float) * s->count);
+    qsort(sorted, s->count, sizeof(float), compareSamples);
+
+    double total = 0;
+    for(int i = 0; i < s->count; i++) total += sorted[i];
+    summary->min = sorted[0];
+    summary->mean = total / s->count;
+    summary->p99 = sorted[(int) ceil(0.99 * s->count) - 1];
+}
+
+// Starts writing every timed stage to a file in Chrome's trace event format, which trace viewers such as
+// chrome://tracing and Perfetto open
+// Returns 1 on success, 0 if the file could not be created
+int startTimingTrace(const char *path)
+{
+    if(traceFile) stopTimingTrace();
+    traceFile = fopen(path, "w");
+    if(!traceFile)
+    {
+        printf("Error: Could not create timing trace %s\n", path);
+        return 0;
+    }
+
+    fprintf(traceFile, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+    traceStart = getTimingClock();
+    traceEvents = 0;
+    frameSolverTime = 0;
+    frameDecisions = 0;
+    return 1;
+}
+
+// Finishes and closes the timing trace
+// Returns 1 if the whole trace was written, 0 otherwise
+int stopTimingTrace()
+{
+    if(!traceFile) return 1;
+    fprintf(traceFile, "\n]}\n");
+    int result = !ferror(traceFile);
+    if(fclose(traceFile)) result = 0;
+    traceFile = NULL;
+    if(!result) printf("Error: Could not write timing trace\n");
+
+    return result;
+}
+
+// Returns 1 if a timing trace is being written, 0 otherwise
+int isTimingTraceOpen()
+{
+    return traceFile != NULL;
+}
@@ -0,0 +1,56 @@
+#ifndef TIMING_H
+#define TIMING_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Stages of the simulator's frame loop that are timed
+typedef enum TimingStage
+{
+    STAGE_FRAME,        // Time from one frame to the next
+    STAGE_SIMULATE,     // Simulation ticks run in a frame, including solver decisions
+    STAGE_SOLVER,       // One solver decision
+    STAGE_MAZE,         // Restoring or redrawing the maze under the frame
+    STAGE_MOUSE,        // Drawing the mouse
+    STAGE_HUD,          // Drawing the timing overlay
+    STAGE_PRESENT,      // Copying the frame to the screen and presenting it
+    STAGE_COUNT
+} TimingStage;
+
+#define TIMING_WINDOW 256   // Latest samples of each stage the rolling statistics cover
+
+// Rolling statistics of one stage (microseconds)
+typedef struct
+{
+    int count;          // Samples the statistics cover
+    double min;
+    double mean;
+    double p99;
+} TimingSummary;
+
+extern int timingEnabled;
+extern const char *timingStageNames[STAGE_COUNT];
+
+// Returns the monotonic clock (nanoseconds)
+static inline uint64_t getTimingClock()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Returns the start time of a stage, or 0 if timing is off; with timing off, instrumenting a stage costs a
+// branch on each end and no clock reads
+static inline uint64_t startTiming()
+{
+    return timingEnabled ? getTimingClock() : 0;
+}
+
+void endTiming(TimingStage stage, uint64_t start);
+void markFrame();
+void summarizeTiming(TimingStage stage, TimingSummary *summary);
+int startTimingTrace(const char *path);
+int stopTimingTrace();
+int isTimingTraceOpen();
+
+#endif
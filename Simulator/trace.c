@@ -0,0 +1,404 @@
+#include <fcntl.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "trace.h"
+
+#define BLOCK_BYTES(interval) (sizeof(TraceKeyframe) + sizeof(uint32_t) * (interval))
+
+// Returns the monotonic clock (nanoseconds)
+static uint64_t getNanoseconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// Waits about the given number of microseconds
+static void sleepMicroseconds(long microseconds)
+{
+    struct timespec ts = {0, microseconds * 1000};
+    nanosleep(&ts, NULL);
+}
+
+// Flush thread: writes whatever the simulation has put in the ring to the trace it belongs to, hands the space
+// back by advancing the tail, and closes each trace once everything up to its end has been written
+static void *flushTrace(void *arg)
+{
+    TraceWriter *writer = arg;
+    size_t tail = atomic_load_explicit(&writer->tail, memory_order_relaxed);
+    size_t fileTail = atomic_load_explicit(&writer->fileTail, memory_order_relaxed);
+    int failed = 0;
+    while(1)
+    {
+        if(fileTail == atomic_load_explicit(&writer->fileHead, memory_order_acquire))
+        {
+            if(atomic_load(&writer->stopping)) break;
+            sleepMicroseconds(1000);
+            continue;
+        }
+
+        // The head is read before the end: a head read afterwards could already hold the next trace's bytes while
+        // the end read here still says the trace is being recorded, and they would go into this trace's file
+        TraceFile *trace = &writer->files[fileTail % TRACE_MAX_FILES];
+        size_t head = atomic_load_explicit(&writer->head, memory_order_acquire);
+        size_t end = atomic_load_explicit(&trace->end, memory_order_acquire);
+        if(head > end) head = end;
+
+        // Write up to the end of the ring; anything that wrapped around goes out on the next pass
+        if(head != tail)
+        {
+            size_t offset = tail & (writer->capacity - 1);
+            size_t length = head - tail;
+            if(length > writer->capacity - offset) length = writer->capacity - offset;
+            if(!failed && fwrite(writer->ring + offset, 1, length, trace->file) != length) failed = 1;
+
+            tail += length;
+            atomic_store_explicit(&writer->tail, tail, memory_order_release);
+        }
+        else if(tail == end)
+        {
+            if(fclose(trace->file)) failed = 1;
+            if(failed)
+            {
+                printf("Error: Could not write trace file\n");
+                atomic_fetch_add(&writer->failures, 1);
+            }
+            failed = 0;
+            atomic_store_explicit(&writer->fileTail, ++fileTail, memory_order_release);
+        }
+        else sleepMicroseconds(1000);
+    }
+
+    return NULL;
+}
+
+// Sets up a trace writer with a ring buffer of at least the given size (and room for two blocks) and starts its
+// flush thread
+// Returns 1 on success, 0 otherwise
+int initTraceWriter(TraceWriter *writer, size_t capacity)
+{
+    memset(writer, 0, sizeof(*writer));
+    size_t size = 4096;
+    while(size < capacity || size < 2 * sizeof(TraceBlock)) size *= 2;
+
+    writer->ring = malloc(size);
+    if(!writer->ring)
+    {
+        printf("Error: unable to allocate trace buffer\n");
+        return 0;
+    }
+    writer->capacity = size;
+    atomic_init(&writer->head, 0);
+    atomic_init(&writer->tail, 0);
+    atomic_init(&writer->fileHead, 0);
+    atomic_init(&writer->fileTail, 0);
+    atomic_init(&writer->failures, 0);
+    atomic_init(&writer->stopping, 0);
+
+    if(pthread_create(&writer->thread, NULL, flushTrace, writer))
+    {
+        printf("Error: unable to start trace flush thread\n");
+        free(writer->ring);
+        writer->ring = NULL;
+        return 0;
+    }
+
+    return 1;
+}
+
+// Ends the current trace, waits for every trace to be written and closed, then stops the flush thread and frees
+// the buffer
+void freeTraceWriter(TraceWriter *writer)
+{
+    if(!writer->ring) return;
+    flushTraces(writer);
+    atomic_store(&writer->stopping, 1);
+    pthread_join(writer->thread, NULL);
+    free(writer->ring);
+    writer->ring = NULL;
+}
+
+// Copies bytes into the ring, waiting for the flush thread if the ring is full
+static void pushTrace(TraceWriter *writer, const void *data, size_t length)
+{
+    size_t head = atomic_load_explicit(&writer->head, memory_order_relaxed);
+    while(head + length - atomic_load_explicit(&writer->tail, memory_order_acquire) > writer->capacity) sched_yield();
+
+    size_t offset = head & (writer->capacity - 1);
+    size_t first = writer->capacity - offset;
+    if(first > length) first = length;
+    memcpy(writer->ring + offset, data, first);
+    memcpy(writer->ring, (const uint8_t *) data + first, length - first);
+
+    atomic_store_explicit(&writer->head, head + length, memory_order_release);
+}
+
+// Puts the block being filled into the ring, if it holds any records
+static void pushBlock(TraceWriter *writer)
+{
+    if(!writer->pending) return;
+    pushTrace(writer, &writer->block, sizeof(TraceKeyframe) + sizeof(uint32_t) * writer->pending);
+    writer->pending = 0;
+}
+
+// Starts recording a new trace to the given file, ending the current one if there is one
+// Returns 1 on success, 0 if the file could not be created
+int beginTrace(TraceWriter *writer, const char *path, const Maze *maze, const char *solverName)
+{
+    endTrace(writer);
+
+    FILE *file = fopen(path, "wb");
+    if(!file)
+    {
+        printf("Error: Could not create trace file %s\n", path);
+        return 0;
+    }
+
+    // The flush thread does not touch the file until it is published below
+    TraceHeader header = {TRACE_MAGIC, TRACE_VERSION, TRACE_KEYFRAME_INTERVAL, maze->size, TRACE_CLOCK_INTERVAL};
+    strncpy(header.mazeName, maze->name, sizeof(header.mazeName) - 1);
+    strncpy(header.solverName, solverName, sizeof(header.solverName) - 1);
+    if(fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        printf("Error: Could not write trace file %s\n", path);
+        fclose(file);
+        return 0;
+    }
+
+    // Wait for a free slot if the flush thread is many traces behind
+    size_t fileHead = atomic_load_explicit(&writer->fileHead, memory_order_relaxed);
+    while(fileHead - atomic_load_explicit(&writer->fileTail, memory_order_acquire) >= TRACE_MAX_FILES)
+    {
+        sleepMicroseconds(100);
+    }
+    TraceFile *trace = &writer->files[fileHead % TRACE_MAX_FILES];
+    trace->file = file;
+    atomic_store_explicit(&trace->end, SIZE_MAX, memory_order_relaxed);
+    atomic_store_explicit(&writer->fileHead, fileHead + 1, memory_order_release);
+
+    writer->recording = 1;
+    writer->step = 0;
+    writer->start = getNanoseconds();
+    writer->last = 0;
+    writer->untilClock = 1;
+    writer->pending = 0;
+    return 1;
+}
+
+// Ends the current trace without waiting for it to reach the file
+void endTrace(TraceWriter *writer)
+{
+    if(!writer->recording) return;
+    pushBlock(writer);
+
+    size_t fileHead = atomic_load_explicit(&writer->fileHead, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&writer->head, memory_order_relaxed);
+    atomic_store_explicit(&writer->files[(fileHead - 1) % TRACE_MAX_FILES].end, head, memory_order_release);
+    writer->recording = 0;
+}
+
+// Ends the current trace and waits until every trace begun so far has been written and closed
+// Returns 1 if all of them were written completely, 0 otherwise
+int flushTraces(TraceWriter *writer)
+{
+    endTrace(writer);
+    while(atomic_load_explicit(&writer->fileTail, memory_order_acquire) !=
+          atomic_load_explicit(&writer->fileHead, memory_order_relaxed)) sleepMicroseconds(100);
+
+    return atomic_exchange(&writer->failures, 0) == 0;
+}
+
+// Packs nanoseconds into the 24-bit delta of a record: a 20-bit mantissa shifted left by a 4-bit exponent
+static uint32_t encodeDelta(uint64_t delta)
+{
+    int exponent = delta >> TRACE_DELTA_BITS ? 64 - TRACE_DELTA_BITS - __builtin_clzll(delta) : 0;
+    if(exponent > 15) return 0xFFFFFF;
+    return (uint32_t) exponent << TRACE_DELTA_BITS | (uint32_t) (delta >> exponent);
+}
+
+// Unpacks the delta of a record (nanoseconds)
+static uint64_t decodeDelta(uint32_t record)
+{
+    return (uint64_t) ((record >> 8) & ((1 << TRACE_DELTA_BITS) - 1)) << (record >> (8 + TRACE_DELTA_BITS));
+}
+
+// Records the decision the mouse is about to carry out, with its sensor readings; call before performAction
+void recordDecision(TraceWriter *writer, Mouse *mouse, Action action)
+{
+    if(!writer->recording) return;
+
+    uint32_t delta = 0;
+    if(!--writer->untilClock)
+    {
+        uint64_t now = getNanoseconds() - writer->start;
+        delta = encodeDelta(now - writer->last);
+        writer->last = now;
+        writer->untilClock = TRACE_CLOCK_INTERVAL;
+    }
+    if(!writer->pending)
+    {
+        writer->block.keyframe = (TraceKeyframe) {writer->step, writer->last, mouse->x, mouse->y, mouse->heading};
+    }
+
+    // Same readings as getLeftReading, getFrontReading and getRightReading, from one lookup of the cell's walls
+    int walls = getWalls(mouse->maze, mouse->x, mouse->y);
+    walls = ((walls | (walls << 4)) >> mouse->heading) & 0xF;
+    int front = walls & 1;
+    writer->block.records[writer->pending++] = action | ((walls >> 3) & 1) << 2 | front << 3 |
+                                               ((walls >> 1) & 1) << 4 |
+                                               (action == FORWARD && front ? TRACE_BLOCKED : 0) | delta << 8;
+    writer->step++;
+    if(writer->pending == TRACE_KEYFRAME_INTERVAL) pushBlock(writer);
+}
+
+// Maps a trace file into memory and checks its header
+// Returns 1 on success, 0 if the file could not be read or is not a trace
+int openTrace(TraceReader *reader, const char *path)
+{
+    memset(reader, 0, sizeof(*reader));
+
+    int file = open(path, O_RDONLY);
+    struct stat info;
+    if(file < 0 || fstat(file, &info))
+    {
+        printf("Error: Could not open file %s\n", path);
+        if(file >= 0) close(file);
+        return 0;
+    }
+    if((size_t) info.st_size < sizeof(TraceHeader))
+    {
+        printf("Error: %s is not a trace\n", path);
+        close(file);
+        return 0;
+    }
+    void *data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if(data == MAP_FAILED)
+    {
+        printf("Error: Could not read file %s\n", path);
+        return 0;
+    }
+    reader->data = data;
+    reader->length = info.st_size;
+    reader->header = data;
+
+    const TraceHeader *header = reader->header;
+    if(memcmp(header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) || header->version != TRACE_VERSION ||
+       !header->keyframeInterval)
+    {
+        printf("Error: %s is not a version %d trace\n", path, TRACE_VERSION);
+        closeTrace(reader);
+        return 0;
+    }
+
+    // A trace cut short (e.g. by a crash) ends part way through a block; only whole records count
+    size_t interval = header->keyframeInterval;
+    size_t body = reader->length - sizeof(TraceHeader);
+    size_t rest = body % BLOCK_BYTES(interval);
+    reader->steps = body / BLOCK_BYTES(interval) * interval;
+    if(rest > sizeof(TraceKeyframe)) reader->steps += (rest - sizeof(TraceKeyframe)) / sizeof(uint32_t);
+
+    return 1;
+}
+
+// Unmaps a trace file
+void closeTrace(TraceReader *reader)
+{
+    if(reader->data) munmap((void *) reader->data, reader->length);
+    memset(reader, 0, sizeof(*reader));
+}
+
+// Returns the record of a step, which must be less than reader->steps
+static uint32_t getRecord(const TraceReader *reader, uint64_t step)
+{
+    uint64_t interval = reader->header->keyframeInterval;
+    const uint8_t *block = reader->data + sizeof(TraceHeader) + step / interval * BLOCK_BYTES(interval);
+    uint32_t record;
+    memcpy(&record, block + sizeof(TraceKeyframe) + sizeof(uint32_t) * (step % interval), sizeof(record));
+    return record;
+}
+
+// Returns the action decided in a step, or -1 if the step is past the end of the trace
+int getTraceAction(const TraceReader *reader, uint64_t step)
+{
+    if(step >= reader->steps) return -1;
+    return getRecord(reader, step) & 3;
+}
+
+// Returns the keyframe of a step's block
+static TraceKeyframe getKeyframe(const TraceReader *reader, uint64_t step)
+{
+    uint64_t interval = reader->header->keyframeInterval;
+    TraceKeyframe keyframe;
+    memcpy(&keyframe, reader->data + sizeof(TraceHeader) + step / interval * BLOCK_BYTES(interval), sizeof(keyframe));
+    return keyframe;
+}
+
+// Fills in the decision made in state's step, or marks the state as past the last decision
+static void loadDecision(const TraceReader *reader, TraceState *state)
+{
+    state->action = -1;
+    state->left = state->front = state->right = state->blocked = 0;
+    if(state->step >= reader->steps) return;
+
+    uint32_t record = getRecord(reader, state->step);
+    state->action = record & 3;
+    state->left = (record >> 2) & 1;
+    state->front = (record >> 3) & 1;
+    state->right = (record >> 4) & 1;
+    state->blocked = (record & TRACE_BLOCKED) != 0;
+}
+
+// Reconstructs the mouse's state at a step, from 0 to reader->steps (the state after the last decision), by
+// starting from the keyframe at or before it and replaying the actions in between
+// Returns 1 on success, 0 if the step is out of range
+int seekTrace(const TraceReader *reader, uint64_t step, TraceState *state)
+{
+    if(!reader->steps || step > reader->steps) return 0;
+
+    // The state after the last decision of a full block is rebuilt from that block's keyframe
+    uint64_t interval = reader->header->keyframeInterval;
+    uint64_t first = (step == reader->steps ? step - 1 : step) / interval * interval;
+    TraceKeyframe keyframe = getKeyframe(reader, first);
+    *state = (TraceState) {first, keyframe.time, keyframe.x, keyframe.y, keyframe.heading & 3};
+    loadDecision(reader, state);
+    while(state->step < step) stepTrace(reader, state);
+
+    return 1;
+}
+
+// Advances a state from seekTrace by one step, carrying out the decision made in it
+// Returns 1 on success, 0 if the state is already past the last decision
+int stepTrace(const TraceReader *reader, TraceState *state)
+{
+    static const int dx[4] = {0, 1, 0, -1};
+    static const int dy[4] = {1, 0, -1, 0};
+    if(state->step >= reader->steps) return 0;
+
+    switch(state->action)
+    {
+        case FORWARD:
+            if(state->blocked) break;
+            state->x += dx[state->heading];
+            state->y += dy[state->heading];
+            break;
+        case LEFT: state->heading = (state->heading + 3) % 4; break;
+        case RIGHT: state->heading = (state->heading + 1) % 4; break;
+    }
+    state->step++;
+
+    // Each block's first decision is timed by its keyframe, the others by their delta from the last timed one
+    if(state->step < reader->steps)
+    {
+        if(state->step % reader->header->keyframeInterval == 0) state->time = getKeyframe(reader, state->step).time;
+        else state->time += decodeDelta(getRecord(reader, state->step));
+    }
+    loadDecision(reader, state);
+
+    return 1;
+}
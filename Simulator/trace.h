@@ -0,0 +1,131 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "maze.h"
+#include "mouse.h"
+
+// Trace files record every solver decision of a run. Layout (little-endian): a TraceHeader, then blocks of one
+// TraceKeyframe followed by up to keyframeInterval 4-byte records, so any step's block is found by arithmetic
+// and the state at any step is the block's keyframe with at most keyframeInterval - 1 actions applied
+// A record packs the decision made in one step:
+//     bits 0-1  action (LEFT, FORWARD, RIGHT or IDLE)
+//     bits 2-4  left, front and right wall sensor readings before the action
+//     bit 5     1 if the action was blocked by a wall and the mouse did not move
+//     bits 8-31 nanoseconds since the previous timed decision: bits 8-27 hold a mantissa and bits 28-31 how far
+//               it is shifted left, so deltas under about 1 ms are exact and longer ones (up to about 34 s, as
+//               between GUI-paced decisions) keep 20 significant bits
+// Reading the clock costs more than a typical decision, so only every clockInterval-th decision is timed and the
+// others record 0; keyframe intervals are multiples of the clock interval, so every keyframe is timed
+#define TRACE_MAGIC "MMTRACE"
+#define TRACE_VERSION 2
+#define TRACE_KEYFRAME_INTERVAL 1024
+#define TRACE_CLOCK_INTERVAL 8
+#define TRACE_DELTA_BITS 20
+#define TRACE_BLOCKED 0x20
+
+// Most traces a writer keeps open while the flush thread catches up
+#define TRACE_MAX_FILES 64
+
+typedef struct
+{
+    char magic[8];              // TRACE_MAGIC
+    uint32_t version;           // TRACE_VERSION
+    uint32_t keyframeInterval;  // Records per block
+    uint32_t mazeSize;
+    uint32_t clockInterval;     // Decisions per clock reading
+    char mazeName[64];
+    char solverName[32];
+} TraceHeader;
+
+// Mouse state before the first decision of a block
+typedef struct
+{
+    uint64_t step;
+    uint64_t time;              // Nanoseconds since the trace was started
+    int32_t x, y;
+    int32_t heading;
+    uint32_t reserved;
+} TraceKeyframe;
+
+// One block as it is laid out in the file
+typedef struct
+{
+    TraceKeyframe keyframe;
+    uint32_t records[TRACE_KEYFRAME_INTERVAL];
+} TraceBlock;
+
+// Trace file being written: the bytes of the ring up to end belong to it
+typedef struct
+{
+    FILE *file;
+    _Atomic size_t end;         // Ring position the trace ends at, SIZE_MAX while it is being recorded
+} TraceFile;
+
+// Writes traces through an in-memory ring buffer that a background thread flushes to disk, so recording only
+// costs the simulation a few stores per decision. Decisions are collected into a block on the writer, which goes
+// into the ring in one piece when it is full or the trace ends. The simulation thread is the only producer and
+// the flush thread the only consumer; each owns one end of the ring, published with release stores
+// One writer can record many traces one after another, reusing its buffer and thread. Ending a trace only marks
+// where it stops in the ring; the flush thread closes the file once it has written everything up to there
+typedef struct TraceWriter
+{
+    uint8_t *ring;
+    size_t capacity;            // Ring size (bytes), a power of two
+    _Atomic size_t head;        // Bytes written into the ring so far (producer)
+    _Atomic size_t tail;        // Bytes flushed to files so far (consumer)
+    TraceFile files[TRACE_MAX_FILES];
+    _Atomic size_t fileHead;    // Traces begun so far (producer)
+    _Atomic size_t fileTail;    // Traces flushed and closed so far (consumer)
+    atomic_int failures;        // Traces that could not be written completely
+    atomic_int stopping;        // Set to end the flush thread
+    pthread_t thread;
+    int recording;              // 1 while a trace is being recorded
+
+    uint64_t step;              // Decisions recorded in the current trace
+    uint64_t start;             // Time the trace was started (nanoseconds, monotonic clock)
+    uint64_t last;              // Time of the last timed decision (nanoseconds since start)
+    int untilClock;             // Decisions until the next timed one, counting the current one
+    int pending;                // Records in block not yet put into the ring
+    TraceBlock block;           // Block being filled
+} TraceWriter;
+
+// Trace file mapped read-only into memory
+typedef struct
+{
+    const uint8_t *data;
+    size_t length;
+    const TraceHeader *header;
+    uint64_t steps;             // Number of decisions recorded
+} TraceReader;
+
+// Mouse state at a step of a trace, and the decision made in it (if the step was recorded)
+typedef struct
+{
+    uint64_t step;
+    uint64_t time;              // Nanoseconds since the trace was started, as of the last timed decision
+    int x, y;
+    Heading heading;
+    int action;                 // Action decided in this step, -1 after the last decision
+    int left, front, right;     // Wall sensor readings before the action
+    int blocked;                // 1 if the action was blocked by a wall
+} TraceState;
+
+int initTraceWriter(TraceWriter *writer, size_t capacity);
+void freeTraceWriter(TraceWriter *writer);
+int beginTrace(TraceWriter *writer, const char *path, const Maze *maze, const char *solverName);
+void endTrace(TraceWriter *writer);
+int flushTraces(TraceWriter *writer);
+void recordDecision(TraceWriter *writer, Mouse *mouse, Action action);
+
+int openTrace(TraceReader *reader, const char *path);
+void closeTrace(TraceReader *reader);
+int seekTrace(const TraceReader *reader, uint64_t step, TraceState *state);
+int stepTrace(const TraceReader *reader, TraceState *state);
+int getTraceAction(const TraceReader *reader, uint64_t step);
+
+#endif
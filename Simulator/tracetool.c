@@ -0,0 +1,196 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "trace.h"
+
+// Global variables
+int MAX_MAZE_SIZE = 1024;           // Maximum maze dimensions (cells)
+int MIN_MAZE_SIZE = 2;              // Minimum maze dimensions (cells)
+char *mazeDirectory = "../Mazes/";  // Path to maze folder
+long long from = 0;                 // First step to print
+long long count = -1;               // Number of steps to print, -1 for all of them
+int summaryOnly = 0;                // 1 to print only the trace's header and totals
+long stressCount = 0;               // Traces to record back to back with --stress, 0 to print a trace
+
+// Output formats
+typedef enum Format {TABLE, CSV} Format;
+Format format = TABLE;
+
+int runStress(const char *folder);
+void printUsage(const char *program);
+
+// MAIN
+// Prints a trace file's header and totals, then the mouse's state and decision at each step of the requested
+// range, seeking straight to the first one
+int main(int argc, char** argv)
+{
+    const char *path = NULL;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--from") && i + 1 < argc) from = atoll(argv[++i]);
+        else if(!strcmp(argv[i], "--count") && i + 1 < argc) count = atoll(argv[++i]);
+        else if(!strcmp(argv[i], "--summary")) summaryOnly = 1;
+        else if(!strcmp(argv[i], "--csv")) format = CSV;
+        else if(!strcmp(argv[i], "--stress") && i + 1 < argc) stressCount = atol(argv[++i]);
+        else if(argv[i][0] != '-' && !path) path = argv[i];
+        else
+        {
+            printUsage(argv[0]);
+            return strcmp(argv[i], "--help") ? -1 : 0;
+        }
+    }
+    if(!path || from < 0)
+    {
+        printUsage(argv[0]);
+        return -1;
+    }
+    if(stressCount > 0) return runStress(path);
+
+    TraceReader reader;
+    if(!openTrace(&reader, path)) return -1;
+
+    // Totals come from one pass over the records, which stays fast even for million-step traces
+    const TraceHeader *header = reader.header;
+    long long actions[4] = {0};
+    for(uint64_t s = 0; s < reader.steps; s++) actions[getTraceAction(&reader, s)]++;
+    TraceState end;
+    int hasEnd = seekTrace(&reader, reader.steps, &end);
+
+    if(format == TABLE || summaryOnly)
+    {
+        printf("Maze: %s (%u x %u)\n", header->mazeName, header->mazeSize, header->mazeSize);
+        printf("Solver: %s\n", header->solverName);
+        printf("Steps: %llu (%lld forward, %lld left, %lld right, %lld idle)\n", (unsigned long long) reader.steps,
+               actions[FORWARD], actions[LEFT], actions[RIGHT], actions[IDLE]);
+        if(hasEnd)
+        {
+            printf("End: (%d, %d) facing %c\n", end.x, end.y, "NESW"[end.heading]);
+            printf("Recorded over: %.3f ms (clock read every %u decisions)\n", end.time * 1e-6, header->clockInterval);
+        }
+        if(summaryOnly)
+        {
+            closeTrace(&reader);
+            return 0;
+        }
+    }
+
+    if(format == TABLE)
+    {
+        printf("\n%10s %12s %5s %5s %7s %7s %7s %7s\n", "step", "time (us)", "x", "y", "heading", "action", "walls",
+               "blocked");
+    }
+    else printf("step,time_ns,x,y,heading,action,left_wall,front_wall,right_wall,blocked\n");
+
+    TraceState state;
+    if(reader.steps && seekTrace(&reader, from < (long long) reader.steps ? from : reader.steps, &state))
+    {
+        for(long long n = 0; (count < 0 || n < count) && state.action >= 0; n++)
+        {
+            char action = "LFRI"[state.action];
+            if(format == TABLE)
+            {
+                char walls[4] = {state.left ? 'L' : '-', state.front ? 'F' : '-', state.right ? 'R' : '-', '\0'};
+                printf("%10llu %12.3f %5d %5d %7c %7c %7s %7s\n", (unsigned long long) state.step, state.time * 1e-3,
+                       state.x, state.y, "NESW"[state.heading], action, walls, state.blocked ? "yes" : "");
+            }
+            else
+            {
+                printf("%llu,%llu,%d,%d,%c,%c,%d,%d,%d,%d\n", (unsigned long long) state.step,
+                       (unsigned long long) state.time, state.x, state.y, "NESW"[state.heading], action, state.left,
+                       state.front, state.right, state.blocked);
+            }
+            stepTrace(&reader, &state);
+        }
+    }
+
+    closeTrace(&reader);
+    return 0;
+}
+
+// Records traces back to back into a folder through the smallest ring, so most traces end while the flush thread
+// is still writing earlier ones and the longest fill the ring while it is being flushed, then reads each one back
+// and checks it holds exactly its own decisions. The first trace is paced like a GUI run, 5 ms per decision, and
+// must read back with its timing intact
+// Returns 0 if every trace matched, -1 otherwise
+int runStress(const char *folder)
+{
+    Maze maze = {0};
+    Mouse mouse = {0};
+    TraceWriter writer;
+    long *steps = malloc(sizeof(long) * stressCount);
+    if(!steps || !clearMaze(&maze, 16) || !initTraceWriter(&writer, 0))
+    {
+        printf("Error: unable to set up the stress run\n");
+        return -1;
+    }
+    initMouse(&mouse, &maze);
+
+    // Most traces are a few dozen decisions; every eighth is up to four times the ring
+    char path[1024];
+    int failed = 0;
+    long ringSteps = (writer.capacity - sizeof(TraceKeyframe)) / sizeof(uint32_t);
+    struct timespec pace = {0, 5000000};
+    srand(1);
+    for(long t = 0; t < stressCount && !failed; t++)
+    {
+        snprintf(path, sizeof(path), "%s/stress_%06ld.trace", folder, t);
+        if(!beginTrace(&writer, path, &maze, "stress")) failed = 1;
+        steps[t] = t ? rand() % (t % 8 ? 64 : 4 * ringSteps) : 3 * TRACE_CLOCK_INTERVAL;
+        for(long s = 0; s < steps[t]; s++)
+        {
+            if(!t) nanosleep(&pace, NULL);
+            recordDecision(&writer, &mouse, (t + s) % 4);
+        }
+        endTrace(&writer);
+    }
+    if(!flushTraces(&writer)) failed = 1;
+    freeTraceWriter(&writer);
+
+    long mismatched = 0;
+    for(long t = 0; t < stressCount && !failed; t++)
+    {
+        snprintf(path, sizeof(path), "%s/stress_%06ld.trace", folder, t);
+        TraceReader reader;
+        if(!openTrace(&reader, path))
+        {
+            failed = 1;
+            break;
+        }
+        int match = reader.steps == (uint64_t) steps[t];
+        for(long s = 0; s < steps[t] && match; s++) match = getTraceAction(&reader, s) == (t + s) % 4;
+
+        // The paced trace's last timed decision came at least 5 ms per decision after its first
+        TraceState state;
+        uint64_t last = 2 * TRACE_CLOCK_INTERVAL;
+        if(match && !t && (!seekTrace(&reader, last, &state) || state.time < last * pace.tv_nsec))
+        {
+            printf("Error: trace %s lost the time between its decisions\n", path);
+            mismatched++;
+        }
+        if(!match)
+        {
+            printf("Error: trace %s does not hold the %ld decisions recorded to it\n", path, steps[t]);
+            mismatched++;
+        }
+        closeTrace(&reader);
+        remove(path);
+    }
+
+    if(!failed) printf("Traces: %ld recorded back to back, %ld mismatched\n", stressCount, mismatched);
+    freeMaze(&maze);
+    free(steps);
+    return failed || mismatched ? -1 : 0;
+}
+
+void printUsage(const char *program)
+{
+    printf("Usage: %s [--from STEP] [--count N] [--summary] [--csv] FILE\n", program);
+    printf("       %s --stress N FOLDER\n", program);
+    printf("  FILE           trace recorded by headless --trace or batch --trace\n");
+    printf("  --from STEP    first step to print (default 0)\n");
+    printf("  --count N      number of steps to print (default: all)\n");
+    printf("  --summary      only print the maze, solver and totals\n");
+    printf("  --csv          print steps as CSV\n");
+    printf("  --stress N     record N traces back to back into FOLDER and check each reads back intact\n");
+}